@@ -0,0 +1,303 @@
+#include "../include/AST/Arena.hpp"
+#include "../include/AST/Parser.hpp"
+#include "../include/Tokenizer/Lexer.hpp"
+#include "../include/Tokenizer/Scanner.hpp"
+#include "../include/Utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Punctuator-heavy line in the style of minified bundles.
+const char* MINIFIED_SNIPPET =
+    "a=b+c*d;if(e!==f&&g<=h){i>>>=1;j[k]=(l|m)^~n}o=p?q:r;s+=t%u-v/w;"
+    "x=!(y===z)||a>>b<<c;for(i=0;i<n;i++){s[i]=t[i]&1;}f(a,b,{c:d,e:[1,2]});";
+
+std::string repeat(const char* snippet, size_t bytes) {
+    std::string out;
+    out.reserve(bytes + strlen(snippet));
+    while (out.size() < bytes) {
+        out += snippet;
+    }
+    return out;
+}
+
+/** Runs `fn` a few times and returns the best wall time in seconds. */
+double best(const std::function<void()>& fn, int runs = 5) {
+    double bestTime = 1e300;
+    for (int i = 0; i < runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        bestTime = std::min(bestTime, elapsed.count());
+    }
+    return bestTime;
+}
+
+void report(const std::string& name, double seconds, size_t bytes) {
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << seconds * 1e3 << " ms" << std::setw(10) << std::setprecision(1)
+              << (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds << " MB/s\n";
+}
+
+/** The linear scan over TokenValue that nextToken() used before the operator trie. */
+Lexer::TokenType linearOperatorScan(std::string_view str, size_t& length) {
+    for (size_t i = Lexer::TK_QUAD_OP_LAST; i > Lexer::TK_SIMPLE_OP_FIRST; i--) {
+        if (Lexer::TokenValue[i] == nullptr) {
+            continue;
+        }
+        if (str.compare(0, strlen(Lexer::TokenValue[i]), Lexer::TokenValue[i]) == 0) {
+            length = strlen(Lexer::TokenValue[i]);
+            return static_cast<Lexer::TokenType>(i);
+        }
+    }
+    return Lexer::TK_NOT_FOUND;
+}
+
+void benchOperators() {
+    std::string source = repeat(MINIFIED_SNIPPET, 4 << 20);
+    Lexer::Lexer lexer{std::string_view(source)};
+    std::vector<size_t> offsets;
+    for (const Lexer::Token& token : lexer.tokenize()) {
+        if (token.type > Lexer::TK_SIMPLE_OP_FIRST && token.type < Lexer::TK_QUAD_OP_LAST) {
+            offsets.push_back(token.value.data() - source.data());
+        }
+    }
+
+    std::string_view view = source;
+    size_t sink = 0;
+    double linear = best([&] {
+        for (size_t offset : offsets) {
+            size_t length = 0;
+            sink += linearOperatorScan(view.substr(offset), length) + length;
+        }
+    });
+    double trie = best([&] {
+        for (size_t offset : offsets) {
+            size_t length = 0;
+            sink += Lexer::Token::matchOperator(view.substr(offset), length) + length;
+        }
+    });
+    std::cout << offsets.size() << " operators (checksum " << sink % 997 << ")\n";
+    report("operators: linear TokenValue scan", linear, source.size());
+    report("operators: trie", trie, source.size());
+    std::cout << "operator matching speedup: " << std::setprecision(1) << linear / trie << "x\n";
+
+    double lexing = best([&] {
+        Lexer::Lexer minified{std::string_view(source)};
+        sink += minified.tokenize().size();
+    });
+    report("tokenize: minified", lexing, source.size());
+}
+
+
+void benchScanKernels() {
+    // One very long line: long identifiers, strings and comments, like a vendor bundle.
+    std::string source = repeat(
+        "var someRatherLongIdentifierName_$1=\"a fairly long string literal with \\\"escapes\\\" inside it\";"
+        "/* a block comment that goes on for quite a while before it ends */ anotherIdentifier=someRatherLongIdentifierName_$1;"
+        "                                        x=1;",
+        8 << 20);
+    const Lexer::Scan::Isa bestIsa = Lexer::Scan::bestIsa();
+    for (Lexer::Scan::Isa isa : {Lexer::Scan::Isa::SCALAR, Lexer::Scan::Isa::SSE2, Lexer::Scan::Isa::AVX2}) {
+        if (!Lexer::Scan::useIsa(isa)) {
+            continue;
+        }
+        size_t tokens = 0;
+        double seconds = best([&] {
+            Lexer::Lexer lexer{std::string_view(source)};
+            tokens = lexer.tokenize().size();
+        });
+        report(std::string("tokenize: long line, ") + Lexer::Scan::isaName(isa), seconds, source.size());
+    }
+    Lexer::Scan::useIsa(bestIsa);
+}
+
+
+void benchUnicode() {
+    // Same shape of code, once pure ASCII and once with non-ASCII identifiers and spaces.
+    std::string ascii = repeat(
+        "var total = 0; for (var index = 0; index < items.length; index++) { total += items[index].price; }\n", 8 << 20);
+    std::string unicode = repeat(
+        "var gesamt\xc3\xa9 = 0;\xc2\xa0" "for (var \xce\xb9 = 0; \xce\xb9 < \xe5\x95\x86\xe5\x93\x81.length; \xce\xb9++) "
+        "{ gesamt\xc3\xa9 += \xe5\x95\x86\xe5\x93\x81[\xce\xb9].price; }\n", 8 << 20);
+    for (const auto& [name, source] : {std::pair{"tokenize: ASCII identifiers", &ascii},
+                                       std::pair{"tokenize: UTF-8 identifiers", &unicode}}) {
+        double seconds = best([&] {
+            Lexer::Lexer lexer{std::string_view(*source)};
+            lexer.tokenize();
+        });
+        report(name, seconds, source->size());
+    }
+}
+
+void benchParallel() {
+    // A 40 MB multi-line bundle.
+    std::string source = repeat(
+        "function update(state, action) {\n"
+        "    var next = state.items.slice(0); // copy\n"
+        "    if (action.type === \"add\" && next.length < 100) { next.push({id: action.id, text: 'item'}); }\n"
+        "    /* keep the list sorted */ next.sort(function (a, b) { return a.id - b.id; });\n"
+        "    return {items: next, count: next.length};\n"
+        "}\n",
+        40 << 20);
+    double serial = best([&] {
+        Lexer::Lexer lexer{std::string_view(source)};
+        lexer.tokenize();
+    }, 3);
+    report("tokenize: 40 MB, serial", serial, source.size());
+    for (size_t threads : {2, 4, 8, 16, 64}) {
+        double seconds = best([&] {
+            Lexer::Lexer lexer{std::string_view(source)};
+            lexer.tokenizeParallel(threads);
+        }, 3);
+        report("tokenizeParallel: 40 MB, " + std::to_string(threads) + " threads", seconds, source.size());
+    }
+}
+
+void benchBatch() {
+    // A monorepo-like batch: many small modules and one large bundle.
+    const std::string module = repeat(
+        "export function f(a, b) { return a.map(function (x) { return x * 2 + b; }); } // helper\n", 8 << 10);
+    std::vector<std::string_view> sources(4000, module);
+    const std::string bundle = repeat("var s = 'bundle'; if (s.length > 3) { s += \"!\"; }\n", 16 << 20);
+    sources.push_back(bundle);
+    size_t bytes = 0;
+    for (std::string_view source : sources) {
+        bytes += source.size();
+    }
+    double serial = best([&] {
+        for (std::string_view source : sources) {
+            Lexer::Lexer lexer{source};
+            lexer.tokenize();
+        }
+    }, 3);
+    report("tokenize: 4000 x 8 KB + 16 MB, one by one", serial, bytes);
+    for (size_t threads : {2, 4, 8, 16}) {
+        double seconds = best([&] { Lexer::lexBatch(sources, threads); }, 3);
+        report("lexBatch: 4000 x 8 KB + 16 MB, " + std::to_string(threads) + " threads", seconds, bytes);
+    }
+}
+
+// Statement- and call-heavy code the parser handles, for the parser benchmarks.
+const char* PARSER_SNIPPET =
+    "function update(state, action) {\n"
+    "    var next = state.items.slice(0);\n"
+    "    if (action.type === \"add\" && next.length < 100) { next.push({id: action.id, text: 'item'}); }\n"
+    "    while (next.length > 50) { next.shift(); }\n"
+    "    return {items: next, count: next.length * 2 + 1, last: next[next.length - 1]};\n"
+    "}\n";
+
+// Operator-heavy statements, mostly exercising the binary operator levels.
+const char* EXPRESSION_SNIPPET =
+    "x = (a + b * c - d % e) << 2 | f & g ^ h && i || j == k;\n"
+    "y = a < b === c >= d != e instanceof f ? 1 : -g * +h;\n";
+
+/** Parses the whole program and keeps the tree, as a compiler would, until it is returned. */
+std::vector<Lexer::AST::Stmt::Ptr> parseAll(Lexer::AST::Parser& parser) {
+    std::vector<Lexer::AST::Stmt::Ptr> program;
+    while (!parser.isAtEnd()) {
+        program.push_back(parser.parseStatement());
+    }
+    return program;
+}
+
+void benchParse() {
+    const std::string source = repeat(PARSER_SNIPPET, 8 << 20);
+    Lexer::Lexer lexer{std::string_view(source)};
+    const Lexer::TokenBuffer tokens = lexer.tokenize();
+    double owned = best([&] {
+        Lexer::AST::Parser parser(tokens);
+        parseAll(parser);
+    }, 3);
+    report("parse: 8 MB, fresh arena", owned, source.size());
+    Lexer::AST::Arena arena;
+    double reused = best([&] {
+        arena.reset();
+        Lexer::AST::Parser parser(tokens, arena);
+        parseAll(parser);
+    }, 3);
+    report("parse: 8 MB, reused arena", reused, source.size());
+    double lazy = best([&] {
+        arena.reset();
+        Lexer::AST::Parser parser(tokens, arena, Lexer::AST::PARSE_LAZY_FUNCTIONS);
+        parseAll(parser);
+    }, 3);
+    report("parse: 8 MB, lazy function bodies", lazy, source.size());
+    double recovering = best([&] {
+        arena.reset();
+        Lexer::AST::Parser parser(tokens, arena, Lexer::AST::PARSE_RECOVER);
+        parseAll(parser);
+    }, 3);
+    report("parse: 8 MB, error recovery on", recovering, source.size());
+    for (size_t threads : {size_t(1), std::max<size_t>(2, Lexer::Utils::ThreadPool::defaultThreads())}) {
+        double parallel = best([&] {
+            arena.reset();
+            Lexer::AST::Parser parser(tokens, arena);
+            Lexer::AST::Program program = parser.parseProgram(threads);
+        }, 3);
+        report("parse: 8 MB, bodies on " + std::to_string(threads) + " thread(s)", parallel, source.size());
+    }
+
+    const std::string expressions = repeat(EXPRESSION_SNIPPET, 8 << 20);
+    Lexer::Lexer expressionLexer{std::string_view(expressions)};
+    const Lexer::TokenBuffer expressionTokens = expressionLexer.tokenize();
+    double seconds = best([&] {
+        arena.reset();
+        Lexer::AST::Parser parser(expressionTokens, arena);
+        parseAll(parser);
+    }, 3);
+    report("parse: 8 MB of expressions", seconds, expressions.size());
+    seconds = best([&] {
+        arena.reset();
+        Lexer::AST::Parser parser(expressionTokens, arena, Lexer::AST::PARSE_EXPLICIT_STACK);
+        parseAll(parser);
+    }, 3);
+    report("parse: 8 MB, explicit-stack exprs", seconds, expressions.size());
+}
+
+void benchRelex() {
+    const std::string source = repeat(PARSER_SNIPPET, 8 << 20);
+    Lexer::Lexer lexer{std::string_view(source)};
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    // Each round applies an edit and undoes it, so the buffer ends up where it started.
+    constexpr int ROUNDS = 50;
+    for (double at : {0.0, 0.5, 1.0}) {
+        // Just before a newline, so that the inserted text starts a new statement.
+        const size_t offset = source.find('\n', static_cast<size_t>(at * static_cast<double>(source.size() - 1)));
+        for (const char* inserted : {" ", " x;"}) {
+            std::string edited = source;
+            edited.insert(offset, inserted);
+            const size_t length = strlen(inserted);
+            double seconds = best([&] {
+                for (int i = 0; i < ROUNDS; i++) {
+                    lexer.relex(tokens, edited, {offset, 0, inserted});
+                    lexer.relex(tokens, source, {offset, length, ""});
+                }
+            }, 3) / (2 * ROUNDS);
+            std::cout << std::left << std::setw(36)
+                      << "relex: 8 MB, '" + std::string(inserted) + "' at " + std::to_string(int(at * 100)) + "%"
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(10) << seconds * 1e3
+                      << " ms per edit\n";
+        }
+    }
+}
+}
+
+int main() {
+    benchOperators();
+    benchScanKernels();
+    benchUnicode();
+    benchParallel();
+    benchBatch();
+    benchParse();
+    benchRelex();
+    return 0;
+}
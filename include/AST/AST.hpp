@@ -1,52 +1,58 @@
 #ifndef JS_CMP_LEXER_AST_HPP
 #define JS_CMP_LEXER_AST_HPP
+#include "FunctionBody.hpp"
 #include "Node.hpp"
+#include "../Tokenizer/Symbol.hpp"
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 namespace Lexer::AST {
+// Strings and vectors are std::pmr and allocate from the parser's Arena, like the nodes holding them.
 
-EXPR(Number, CTOR(value(std::move(value))), std::string value)
+EXPR(Number, CTOR(value(std::move(value)), number(number)), std::pmr::string value, double number)
 
-EXPR(String, CTOR(value(std::move(value))), std::string value)
+/** `value` is the literal as written (opposite quote escaped), `utf16` the decoded string. */
+EXPR(String, CTOR(value(std::move(value)), utf16(std::move(utf16))), std::pmr::string value, std::pmr::u16string utf16)
 
-EXPR(Boolean, CTOR(value(std::move(value))), std::string value)
+EXPR(Boolean, CTOR(value(std::move(value))), std::pmr::string value)
 
-EXPR(RegularExpression, CTOR(value(std::move(value))), std::string value)
+EXPR(RegularExpression, CTOR(value(std::move(value))), std::pmr::string value)
 
-EXPR(Array, CTOR(elements(std::move(elements))), std::vector<Expr::Ptr> elements)
+EXPR(Array, CTOR(elements(std::move(elements))), std::pmr::vector<Expr::Ptr> elements)
 
-using Property = std::pair<std::string, Expr::Ptr>;
-EXPR(Object, CTOR(properties(std::move(properties))), std::vector<Property> properties)
+using Property = std::pair<std::pmr::string, Expr::Ptr>;
+EXPR(Object, CTOR(properties(std::move(properties))), std::pmr::vector<Property> properties)
 
 EXPR_DEFAULT(Null)
 EXPR_DEFAULT(Undefined)
 EXPR_DEFAULT(This)
 
-EXPR(Identifier, CTOR(name(std::move(name))), std::string name)
+EXPR(Identifier, CTOR(name(name)), Symbol name)
 
 EXPR(Grouped, CTOR(expression(std::move(expression))), Expr::Ptr expression)
 
-EXPR(BinaryExpr, CTOR(left(std::move(left)), op(std::move(op)), right(std::move(right))), Expr::Ptr left, std::string op, Expr::Ptr right)
+EXPR(BinaryExpr, CTOR(left(std::move(left)), op(std::move(op)), right(std::move(right))), Expr::Ptr left, std::pmr::string op, Expr::Ptr right)
 
-EXPR(AssignementExpr, CTOR(left(std::move(left)), op(std::move(op)), right(std::move(right))), Expr::Ptr left, std::string op, Expr::Ptr right)
+EXPR(AssignementExpr, CTOR(left(std::move(left)), op(std::move(op)), right(std::move(right))), Expr::Ptr left, std::pmr::string op, Expr::Ptr right)
 
-EXPR(UnaryExpr, CTOR(op(std::move(op)), expr(std::move(expr))), std::string op, Expr::Ptr expr)
+EXPR(UnaryExpr, CTOR(op(std::move(op)), expr(std::move(expr))), std::pmr::string op, Expr::Ptr expr)
 
-EXPR(PostfixExpr, CTOR(op(std::move(op)), expr(std::move(expr))), std::string op, Expr::Ptr expr)
+EXPR(PostfixExpr, CTOR(op(std::move(op)), expr(std::move(expr))), std::pmr::string op, Expr::Ptr expr)
 
 EXPR(ConditionalExpr, CTOR(condition(std::move(condition)), trueExpr(std::move(trueExpr)), falseExpr(std::move(falseExpr))), Expr::Ptr condition, Expr::Ptr trueExpr, Expr::Ptr falseExpr)
 
-EXPR(NewExpr, CTOR(callee(std::move(callee)), arguments(std::move(arguments))), Expr::Ptr callee, std::vector<Expr::Ptr> arguments)
+EXPR(NewExpr, CTOR(callee(std::move(callee)), arguments(std::move(arguments))), Expr::Ptr callee, std::pmr::vector<Expr::Ptr> arguments)
 
 EXPR(MemberExpr, CTOR(object(std::move(object)), property(std::move(property)), computed(computed)), Expr::Ptr object, Expr::Ptr property, bool computed)
 
-EXPR(CallExpr, CTOR(callee(std::move(callee)), arguments(std::move(arguments))), Expr::Ptr callee, std::vector<Expr::Ptr> arguments)
+EXPR(CallExpr, CTOR(callee(std::move(callee)), arguments(std::move(arguments))), Expr::Ptr callee, std::pmr::vector<Expr::Ptr> arguments)
 
-EXPR(FunctionExpr, CTOR(name(std::move(name)), params(std::move(params)), body(std::move(body))), std::string name, std::vector<std::string> params, Stmt::Ptr body)
+EXPR(FunctionExpr, CTOR(name(name), params(std::move(params)), body(std::move(body))), Symbol name, std::pmr::vector<Symbol> params, FunctionBody body)
 
-STMT(BlockStmt, CTOR(body(std::move(body))), std::vector<Stmt::Ptr> body)
+STMT(BlockStmt, CTOR(body(std::move(body))), std::pmr::vector<Stmt::Ptr> body)
 
-STMT(VarDecl, CTOR(name(std::move(name)), init(std::move(init))), std::string name, Expr::Ptr init)
+STMT(VarDecl, CTOR(name(name), init(std::move(init))), Symbol name, Expr::Ptr init)
 
 STMT(ExpressionStmt, CTOR(expression(std::move(expression))), Expr::Ptr expression)
 
@@ -60,29 +66,32 @@ STMT(ForStmt, CTOR(init(std::move(init)), test(std::move(test)), update(std::mov
 
 STMT(ForInStmt, CTOR(left(std::move(left)), right(std::move(right)), body(std::move(body))), Stmt::Ptr left, Expr::Ptr right, Stmt::Ptr body)
 
-STMT(ContinueStmt, CTOR(label(std::move(label))), std::string label)
+STMT(ContinueStmt, CTOR(label(label)), Symbol label)
 
-STMT(BreakStmt, CTOR(label(std::move(label))), std::string label)
+STMT(BreakStmt, CTOR(label(label)), Symbol label)
 
 STMT(ReturnStmt, CTOR(argument(std::move(argument))), Expr::Ptr argument)
 
 STMT(WithStmt, CTOR(object(std::move(object)), body(std::move(body))), Expr::Ptr object, Stmt::Ptr body)
 
-STMT(SwitchStmt, CTOR(discriminant(std::move(discriminant)), cases(std::move(cases))), Expr::Ptr discriminant, std::vector<Stmt::Ptr> cases)
+STMT(SwitchStmt, CTOR(discriminant(std::move(discriminant)), cases(std::move(cases))), Expr::Ptr discriminant, std::pmr::vector<Stmt::Ptr> cases)
 
-STMT(SwitchCaseStmt, CTOR(test(std::move(test)), consequent(std::move(consequent))), Expr::Ptr test, std::vector<Stmt::Ptr> consequent)
+STMT(SwitchCaseStmt, CTOR(test(std::move(test)), consequent(std::move(consequent))), Expr::Ptr test, std::pmr::vector<Stmt::Ptr> consequent)
 
-STMT(LabeledStmt, CTOR(label(std::move(label)), body(std::move(body))), std::string label, Stmt::Ptr body)
+STMT(LabeledStmt, CTOR(label(label), body(std::move(body))), Symbol label, Stmt::Ptr body)
 
 STMT(ThrowStmt, CTOR(argument(std::move(argument))), Expr::Ptr argument)
 
-STMT(TryStmt, CTOR(block(std::move(block)), param(std::move(param)), handler(std::move(handler)), finalizer(std::move(finalizer))), Stmt::Ptr block, std::string param, Stmt::Ptr handler, Stmt::Ptr finalizer)
+STMT(TryStmt, CTOR(block(std::move(block)), param(param), handler(std::move(handler)), finalizer(std::move(finalizer))), Stmt::Ptr block, Symbol param, Stmt::Ptr handler, Stmt::Ptr finalizer)
 
 STMT_DEFAULT(DebuggerStmt)
 
 STMT_DEFAULT(EmptyStmt)
 
-STMT(FunctionDecl, CTOR(name(std::move(name)), params(std::move(params)), body(std::move(body))), std::string name, std::vector<std::string> params, Stmt::Ptr body)
+/** Stands for the tokens skipped after a syntax error under PARSE_RECOVER; Parser::diagnostics() says why. */
+STMT_DEFAULT(ErrorStmt)
+
+STMT(FunctionDecl, CTOR(name(name), params(std::move(params)), body(std::move(body))), Symbol name, std::pmr::vector<Symbol> params, FunctionBody body)
 
 }
 
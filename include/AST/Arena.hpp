@@ -0,0 +1,54 @@
+#ifndef JS_CMP_LEXER_ARENA_HPP
+#define JS_CMP_LEXER_ARENA_HPP
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace Lexer::AST {
+/**
+ * Bump allocator for one compilation's AST: nodes and their vectors and strings allocate from it, nothing is
+ * freed individually, and reset() drops the whole tree at once. Blocks are kept across resets, so a
+ * long-lived arena stops allocating once it has grown to the largest unit it has parsed.
+ * Not thread-safe; use one arena per thread.
+ */
+class Arena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_BLOCK = 64 * 1024;
+
+    explicit Arena(size_t firstBlock = DEFAULT_BLOCK);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /** Forgets every allocation. Nodes are not destroyed, so anything they hold must live in the arena too. */
+    void reset();
+
+    /** Bytes handed out since the last reset. */
+    size_t used() const;
+
+    /** Bytes held in blocks. */
+    size_t capacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::vector<Block> blocks;
+    size_t firstBlock;
+    size_t current = 0; /**< Block being filled. */
+    size_t offset = 0; /**< Bytes used in the current block. */
+    size_t usedBefore = 0; /**< Bytes handed out from the blocks before the current one. */
+};
+}
+
+#endif //JS_CMP_LEXER_ARENA_HPP
@@ -0,0 +1,52 @@
+#ifndef JS_CMP_LEXER_FUNCTION_BODY_HPP
+#define JS_CMP_LEXER_FUNCTION_BODY_HPP
+#include "Arena.hpp"
+#include "Node.hpp"
+#include "../Tokenizer/TokenBuffer.hpp"
+
+namespace Lexer::AST {
+/**
+ * Body of a function declaration or expression. With PARSE_LAZY_FUNCTIONS it starts as the token index of
+ * its '{', already brace-matched by the parser, and the BlockStmt is built in the original arena the first
+ * time it is accessed; syntax errors inside the body are thrown then. The token buffer and arena must
+ * outlive the node. Building is not synchronized: do not access the same unparsed body from two threads.
+ */
+class FunctionBody {
+public:
+    explicit FunctionBody(Stmt::Ptr body)
+        : body(std::move(body)) {
+    }
+
+    FunctionBody(const TokenBuffer& tokens, Arena& arena, size_t begin, flag_t flags, size_t depthLimit)
+        : tokens(&tokens), arena(&arena), begin(begin), flags(flags), depthLimit(depthLimit) {
+    }
+
+    /** The BlockStmt, parsed now if it was deferred. */
+    const Stmt::Ptr& get() const;
+
+    const Stmt* operator->() const {
+        return this->get().get();
+    }
+
+    bool parsed() const {
+        return this->body != nullptr;
+    }
+
+    /** Token index of the opening brace, or 0 for a body that was parsed eagerly. */
+    size_t firstToken() const {
+        return this->begin;
+    }
+
+private:
+    friend class Parser;
+
+    mutable Stmt::Ptr body;
+    const TokenBuffer* tokens = nullptr;
+    Arena* arena = nullptr;
+    size_t begin = 0;
+    flag_t flags = 0;
+    size_t depthLimit = 0; /**< Of the parser that deferred the body; nesting is counted from the body. */
+};
+}
+
+#endif //JS_CMP_LEXER_FUNCTION_BODY_HPP
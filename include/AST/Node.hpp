@@ -1,15 +1,31 @@
 #ifndef JS_CMP_LEXER_NODE_HPP
 #define JS_CMP_LEXER_NODE_HPP
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <sstream>
 
 namespace Lexer::AST {
 class Parser;
 
+typedef enum : std::uint8_t {
+    PARSE_LAZY_FUNCTIONS = 0x1, /**< Pre-parse function bodies and build their AST on first access. */
+    PARSE_EXPLICIT_STACK = 0x2, /**< Keep expression and block nesting on the heap instead of the call stack. */
+    PARSE_RECOVER = 0x4 /**< Record syntax errors as diagnostics and resume at the next statement. */
+} ParseFlag;
+
+using flag_t = uint32_t;
+
+/** Nodes live in the parser's Arena and are freed with it, so owning pointers never delete. */
+struct NodeDeleter {
+    void operator()(const class Node*) const noexcept {
+    }
+};
+
 class Node {
 public:
-    using Ptr = std::unique_ptr<Node>;
+    using Ptr = std::unique_ptr<Node, NodeDeleter>;
 
     virtual ~Node() = default;
     virtual void print(size_t indent = 0) const = 0;
@@ -19,14 +35,14 @@ public:
 
 class Expr : public Node {
 public:
-    using Ptr = std::unique_ptr<Expr>;
+    using Ptr = std::unique_ptr<Expr, NodeDeleter>;
     static Expr::Ptr parse(Parser& parser);
 };
 
 
 class Stmt : public Node {
 public:
-    using Ptr = std::unique_ptr<Stmt>;
+    using Ptr = std::unique_ptr<Stmt, NodeDeleter>;
     static Stmt::Ptr parse(Parser& parser);
 };
 }
@@ -1,14 +1,21 @@
 #ifndef JS_CMP_LEXER_PARSER_HPP
 #define JS_CMP_LEXER_PARSER_HPP
+#include "Arena.hpp"
+#include "FunctionBody.hpp"
 #include "Node.hpp"
-#include "../Tokenizer/Token.hpp"
-#include <functional>
+#include "../Tokenizer/Lexer.hpp"
+#include "../Tokenizer/TokenStream.hpp"
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
 
 
 // Green for __FUNCTION__ / __CLASS__ / __LINE__ , blue for token info
 #define DEBUG_PARSER(token) std::cout << "\033[1;32mIn " << __PRETTY_FUNCTION__ << " at line " << __LINE__ << ":\033[0m " \
                                    << "\033[1;34mToken: '" << token.value << "' Type: " << TokenName[token.type] \
-                                   << " Line: " << token.line << " Col: " << token.column << "\033[0m\n";
+                                   << " Offset: " << token.offset << "\033[0m\n";
 
 namespace Lexer::AST {
 class ParseError : public std::runtime_error {
@@ -18,16 +25,100 @@ public:
     }
 };
 
+/** A syntax error that PARSE_RECOVER parsed past. */
+struct Diagnostic {
+    ParseError error; /**< Copies share the message, so recording one does not allocate it again. */
+    size_t token; /**< Index of the token the error was raised at. */
+};
+
+/** Top-level statements of a source, and the arenas that hold the function bodies built by parseProgram(). */
+struct Program {
+    std::vector<Stmt::Ptr> statements;
+    std::vector<std::unique_ptr<Arena>> arenas;
+};
+
+/**
+ * Nodes are allocated from `arena` and live until it is reset or destroyed; without one, the parser owns an
+ * arena and the nodes live as long as the parser.
+ * `flags` are ParseFlag bits. PARSE_LAZY_FUNCTIONS needs the whole token buffer and is ignored when streaming.
+ * PARSE_EXPLICIT_STACK parses expressions, blocks and if/else chains with frames on the heap, building the
+ * same tree; statements nested in other statements and function bodies still recurse, once per level.
+ * PARSE_RECOVER turns each statement that fails into an ErrorStmt and records the error in diagnostics(); bodies
+ * are then only deferred by parseProgram(), which collects the diagnostics of the bodies it builds.
+ */
 class Parser {
 public:
-    explicit Parser(const std::vector<Token>& tokens)
-        : tokens(tokens), cursor(0) {
+    /** Nesting is not limited unless setDepthLimit() is called. */
+    static constexpr size_t NO_DEPTH_LIMIT = SIZE_MAX;
+    /** A limit for setDepthLimit() that is well within the call stack of the recursive parser. */
+    static constexpr size_t DEFAULT_DEPTH_LIMIT = 1000;
+
+    explicit Parser(const TokenBuffer& tokens, flag_t flags = 0)
+        : tokens(tokens), cursor(0), ownArena(std::make_unique<Arena>()), arena(*ownArena), buffer(&tokens),
+          flags(flags) {
+    }
+
+    Parser(const TokenBuffer& tokens, Arena& arena, flag_t flags = 0)
+        : tokens(tokens), cursor(0), arena(arena), buffer(&tokens), flags(flags) {
+    }
+
+    /** Streams tokens from `lexer` instead of a pre-lexed buffer; `reverse()` may go back at most `window` tokens. */
+    explicit Parser(Lexer& lexer, size_t window = TokenStream::DEFAULT_WINDOW)
+        : tokens(lexer, window), cursor(0), ownArena(std::make_unique<Arena>()), arena(*ownArena) {
+    }
+
+    Parser(Lexer& lexer, Arena& arena, size_t window = TokenStream::DEFAULT_WINDOW)
+        : tokens(lexer, window), cursor(0), arena(arena) {
     }
 
     ~Parser() = default;
 
+    /**
+     * Nesting depth, counted in statements and unary-level expressions, past which parsing fails with a
+     * ParseError instead of running out of stack. There is no limit by default; set one, e.g.
+     * DEFAULT_DEPTH_LIMIT, before parsing untrusted input, and a higher one with PARSE_EXPLICIT_STACK.
+     */
+    void setDepthLimit(size_t limit) {
+        this->depthLimit = limit;
+    }
+
+    /** Constructs a node in the arena. */
+    template <typename T, typename... Args>
+    std::unique_ptr<T, NodeDeleter> make(Args&&... args) {
+        return std::unique_ptr<T, NodeDeleter>(this->allocator().new_object<T>(std::forward<Args>(args)...));
+    }
+
+    /** For the strings and vectors held by nodes. */
+    std::pmr::polymorphic_allocator<> allocator() const {
+        return &this->arena;
+    }
+
     Stmt::Ptr parseStatement();
 
+    /** The errors recovered from under PARSE_RECOVER, in source order. */
+    const std::vector<Diagnostic>& diagnostics() const {
+        return this->errors;
+    }
+
+    /**
+     * Parses the remaining statements with their function bodies deferred, then builds the bodies on
+     * `threads` workers (0 for one per hardware thread), nesting level by nesting level, each worker in its
+     * own arena of the result. The tree is the same for any thread count, and so is the error: the first
+     * ParseError in source order is rethrown once every body has been tried. Parses sequentially when
+     * streaming.
+     */
+    Program parseProgram(size_t threads = 0);
+
+    /** The '{...}' body of a function, pre-parsed and deferred under PARSE_LAZY_FUNCTIONS. */
+    FunctionBody parseFunctionBody();
+
+    /** Lets parseProgram() build `body` on a worker; call once the body has been moved into its node. */
+    void deferBody(FunctionBody& body) {
+        if (this->deferred != nullptr && !body.parsed()) {
+            this->deferred->push_back(&body);
+        }
+    }
+
     Expr::Ptr parsePrimary();
 
     Expr::Ptr parseNewOrMember();
@@ -36,39 +127,200 @@ public:
     Expr::Ptr parsePostfix();
     Expr::Ptr parseUnary();
 
-    Expr::Ptr parseMultiplicative();
-    Expr::Ptr parseAdditive();
-    Expr::Ptr parseShift();
-    Expr::Ptr parseRelational();
-    Expr::Ptr parseEquality();
-    Expr::Ptr parseBitwiseAnd();
-    Expr::Ptr parseBitwiseXor();
-    Expr::Ptr parseBitwiseOr();
-    Expr::Ptr parseLogicalAnd();
-    Expr::Ptr parseLogicalOr();
-    Expr::Ptr parseConditional();
-    Expr::Ptr parseAssignment();
-    Expr::Ptr parseComma();
-
-    Expr::Ptr parseExpression();
+    /** Binary operators from `||` to `*`, left-associative, binding tighter than `minPower`. */
+    Expr::Ptr parseBinary(uint8_t minPower = 0, bool noIn = false);
+    Expr::Ptr parseConditional(bool noIn = false);
+    Expr::Ptr parseAssignment(bool noIn = false);
+    Expr::Ptr parseComma(bool noIn = false);
+
+    /**
+     * `noIn` leaves a top-level `in` unparsed, for the init clause of a `for`; nested parentheses, brackets
+     * and calls parse it again.
+     */
+    Expr::Ptr parseExpression(bool noIn = false);
 
     // Token Utils
-    bool match(TokenType type, const std::string& lexme = "");
-    Token consume(std::function<bool(const Token&)> predicate, const std::string& ParserName, const std::string& errorMessage);
-    Token consume(TokenType type, const std::string& ParserName, const std::string& errorMessage);
-    const Token& peek() const;
-    const Token& advance();
-    const Token& reverse();
-    const Token& previous() const;
-    bool check(TokenType type, const std::string& lexme = "");
+    // Matching only looks at token types; the current token is materialized when a caller needs its text,
+    // and error messages are only built when a match fails.
+    bool check(TokenType type) const {
+        const TokenType current = this->tokens.type(this->cursor);
+        return current != TK_EOS && current == type;
+    }
+
+    bool checkAny(TokenSet types) const {
+        const TokenType current = this->tokens.type(this->cursor);
+        return current != TK_EOS && types.contains(current);
+    }
+
+    bool match(TokenType type) {
+        if (this->check(type)) {
+            this->cursor++;
+            return true;
+        }
+        return false;
+    }
+
+    /** Consumes the current token if its type is in `types`; previous() is then the matched token. */
+    bool matchAny(TokenSet types) {
+        if (this->checkAny(types)) {
+            this->cursor++;
+            return true;
+        }
+        return false;
+    }
+
+    bool check(TokenType type, std::string_view lexme) const;
+    bool match(TokenType type, std::string_view lexme);
+
+    /** Consumes and returns the current token if `predicate(token)` holds, throws ParseError otherwise. */
+    template <typename Predicate>
+    Token consume(Predicate predicate, std::string_view parserName, std::string_view errorMessage) {
+        Token token = this->peek();
+        if (predicate(token)) {
+            this->cursor++;
+            return token;
+        }
+        this->fail(parserName, errorMessage);
+    }
+
+    Token consume(TokenSet types, std::string_view parserName, std::string_view errorMessage) {
+        if (this->checkAny(types)) {
+            return this->tokens.at(this->cursor++);
+        }
+        this->fail(parserName, errorMessage);
+    }
+
+    Token consume(TokenType type, std::string_view parserName, std::string_view errorMessage) {
+        if (this->check(type)) {
+            return this->tokens.at(this->cursor++);
+        }
+        this->fail(parserName, errorMessage);
+    }
+
+    Token peek() const;
+    Token advance();
+    Token reverse();
+    Token previous() const;
     bool matchSemicolon(bool needAdvance = false);
-    void expectSemicolon(const std::string& ParserName, const std::string& errorMessage);
-    bool isAtEnd() const;
-    void skipEols();
+    void expectSemicolon(std::string_view parserName, std::string_view errorMessage);
+
+    bool isAtEnd() const {
+        return this->tokens.type(this->cursor) == TK_EOS;
+    }
+
+    /** "line L col C" of `token`, for error messages. */
+    std::string position(const Token& token) const;
 
 private:
-    const std::vector<Token>& tokens;
+    friend class FunctionBody;
+
+    /** Bodies deferred while parsing part of a program, its diagnostics and the first error it could not recover from. */
+    struct Outline {
+        std::vector<FunctionBody*> bodies;
+        std::vector<Diagnostic> diagnostics;
+        std::exception_ptr error;
+        size_t errorAt = SIZE_MAX; /**< Token index the error was raised at. */
+
+        /** Keeps the current exception if it was raised before the one already kept. */
+        void fail(size_t at);
+        void merge(Outline& other);
+    };
+
+    /** Builds `body` in `arena`, deferring the bodies nested in it to `outline`. */
+    static void buildBody(FunctionBody& body, Arena& arena, Outline& outline);
+
+    /** Where the PARSE_EXPLICIT_STACK parser resumes a frame: one step per call site of the recursive parser. */
+    enum class ExprStep : uint8_t {
+        COMMA, COMMA_LEFT, COMMA_RIGHT,
+        ASSIGNMENT, ASSIGNMENT_LEFT, ASSIGNMENT_RIGHT,
+        CONDITIONAL, CONDITIONAL_TEST, CONDITIONAL_TRUE, CONDITIONAL_FALSE,
+        BINARY, BINARY_LEFT, BINARY_RIGHT,
+        UNARY, UNARY_OPERAND, UNARY_POSTFIX,
+        LEFT_HAND_SIDE, LEFT_HAND_SIDE_OBJECT, LEFT_HAND_SIDE_PROPERTY, LEFT_HAND_SIDE_ARGUMENT,
+        NEW_OR_MEMBER, NEW_CALLEE, NEW_ARGUMENT, MEMBER_OBJECT, MEMBER_PROPERTY,
+        PRIMARY, ARRAY_NEXT, ARRAY_ELEMENT, OBJECT_KEY, OBJECT_VALUE, GROUPED,
+    };
+
+    struct ExprFrame {
+        ExprStep step;
+        bool noIn;
+        uint8_t power; /**< `minPower` of a BINARY frame. */
+        std::string_view op; /**< Pending operator. */
+        size_t mark; /**< Where the elements, arguments or keys of this frame start on `items` and `keys`. */
+        Expr::Ptr expr; /**< Left operand, callee or object. */
+        Expr::Ptr middle; /**< True branch of a conditional. */
+    };
+
+    enum class StmtStep : uint8_t { STATEMENT, BLOCK, BLOCK_ITEM, IF_CONSEQUENT, IF_ALTERNATE };
+
+    struct StmtFrame {
+        StmtStep step;
+        size_t start; /**< Token the statement starts at, for recovery. */
+        size_t mark; /**< Where the statements of this block start on `statements`. */
+        Expr::Ptr test;
+        Stmt::Ptr consequent;
+    };
+
+    /** Counts one level of nesting for the duration of a recursive call. */
+    struct DepthGuard {
+        explicit DepthGuard(Parser& parser)
+            : parser(parser) {
+            parser.enter();
+        }
+
+        ~DepthGuard() {
+            this->parser.depth--;
+        }
+
+        Parser& parser;
+    };
+
+    /** The statement at the cursor; the statements nested in it go back through parseStatement(). */
+    Stmt::Ptr dispatchStatement();
+    Stmt::Ptr parseStatementIteratively();
+    /** What the recursive parser would return from the function `start` stands for. */
+    Expr::Ptr parseExpressionIteratively(ExprStep start, bool noIn);
+    void pushExpr(ExprStep step, bool noIn, uint8_t power = 0);
+    void pushStmt();
+    /** Moves the entries of the finished frame starting at `mark` off the shared stacks into a node vector. */
+    std::pmr::vector<Expr::Ptr> takeItems(size_t mark);
+    std::pmr::vector<std::pair<std::pmr::string, Expr::Ptr>> takeProperties(size_t mark);
+    std::pmr::vector<Stmt::Ptr> takeStatements(size_t mark);
+
+    /** Throws once nesting goes past the depth limit. */
+    void enter();
+
+    /** Records `error`, skips the rest of the statement that started at token `start` and stands in for it. */
+    Stmt::Ptr recover(const ParseError& error, size_t start);
+    /** Moves the cursor past the rest of the statement that started at token `start`. */
+    void skipStatement(size_t start);
+
+    /** Brace-matches a block without building it; throws ParseError if it is unbalanced or has illegal tokens. */
+    void skipBlock();
+
+    /** An expression statement, or a labeled statement when the expression is a lone identifier before ':'. */
+    Stmt::Ptr parseExpressionOrLabel();
+
+    /** Throws the "[parserName] errorMessage at ... Found '...'" error for the current token. */
+    [[noreturn]] void fail(std::string_view parserName, std::string_view errorMessage, std::string_view end = "") const;
+
+    TokenStream tokens;
     size_t cursor;
+    std::unique_ptr<Arena> ownArena;
+    Arena& arena;
+    const TokenBuffer* buffer = nullptr; /**< Source of deferred bodies; null when streaming. */
+    flag_t flags = 0;
+    std::vector<TokenType> closers; /**< skipBlock() and skipStatement() bracket stack, reused across calls. */
+    std::vector<FunctionBody*>* deferred = nullptr; /**< Where deferBody() records bodies during parseProgram(). */
+    size_t depth = 0;
+    size_t depthLimit = NO_DEPTH_LIMIT;
+    std::vector<Diagnostic> errors;
+    // PARSE_EXPLICIT_STACK state; nested runs work above the frames and items of the run they interrupt.
+    std::vector<ExprFrame> exprFrames;
+    std::vector<StmtFrame> stmtFrames;
+    std::vector<Expr::Ptr> items; /**< Array elements, arguments and object values of the open frames. */
+    std::vector<std::pmr::string> keys; /**< Object keys of the open frames. */
+    std::vector<Stmt::Ptr> statements; /**< Statements of the open blocks. */
 };
 }
 
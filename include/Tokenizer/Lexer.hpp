@@ -1,26 +1,131 @@
 #ifndef LEXER_HPP
 #define LEXER_HPP
 
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 #include "Token.hpp"
+#include "TokenBuffer.hpp"
 
 namespace Lexer {
+    /** `removed` bytes at `offset` replaced by `inserted`. */
+    struct TextEdit {
+        size_t offset;
+        size_t removed;
+        std::string_view inserted;
+    };
+
+    struct LexedSource;
+
     class Lexer {
     public:
+        /** Copies `content`; the lexer owns its source. */
         explicit Lexer(std::string &content);
         explicit Lexer(const char *content);
+        /**
+         * Borrows `content` without copying; the caller keeps it alive while tokens are in use.
+         * Tokens also reference strings decoded by the lexer, so it has to outlive them too.
+         */
+        explicit Lexer(std::string_view content);
+
+        /** Lexes straight from a read-only memory mapping of the file at `path`. */
+        static Lexer fromFile(const std::string &path);
 
-        std::vector<Token> tokenize();
+        TokenBuffer tokenize();
+        /**
+         * Same result as tokenize(), lexed in newline-aligned chunks on `threads` workers (0: one per core).
+         * Small inputs fall back to tokenize().
+         */
+        TokenBuffer tokenizeParallel(size_t threads = 0);
         Token nextToken();
 
+        /**
+         * Updates `tokens`, lexed by this lexer, after `edit` turned the source into `edited`.
+         * Only the tokens from just before the edit until the stream lines up again with the old tokens are
+         * re-lexed; later tokens are shifted, see TokenBuffer::splice() for that cost. The lexer then borrows
+         * `edited`, which the caller keeps alive.
+         */
+        void relex(TokenBuffer &tokens, std::string_view edited, const TextEdit &edit);
+
         void leftTrim();
 
-        std::string content;
+        /** Returns a view of `length` bytes of the source starting at `start`. */
+        std::string_view view(size_t start, size_t length) const;
+
+        std::string_view content;
         size_t cursor;
-        size_t line;
-        size_t start_of_line;
 
+    private:
+        /** Tokens lexed from a chunk start up to `end`, and the first token at or after `end` (or TK_EOS). */
+        struct Chunk {
+            TokenBuffer tokens;
+            Token next;
+            std::vector<std::unique_ptr<const std::u16string>> strings;
+        };
+
+        /**
+         * Bytes past its end a token may look at to decide where it ends. An identifier decodes the whole
+         * UTF-8 sequence after it, up to 4 bytes, to see whether it goes on.
+         */
+        static constexpr size_t TOKEN_LOOKAHEAD = 4;
+
+        /** Inputs under this many bytes per worker are not worth splitting. */
+        static constexpr size_t PARALLEL_MIN_CHUNK = 256 * 1024;
+
+        Lexer(std::string_view content, std::shared_ptr<const void> source);
+        /** Chunk boundaries from the cursor to the end, each after a newline near an even split. */
+        std::vector<size_t> chunkBounds(size_t chunks) const;
+        Chunk lexChunk(size_t begin, size_t end) const;
+        /** Joins chunks lexed from `bounds`, re-lexing any chunk whose cut landed inside a token. */
+        TokenBuffer stitch(std::vector<Chunk> &lexed, const std::vector<size_t> &bounds);
+        /** Tokenizes every lexer on one pool, splitting large sources and packing small ones. */
+        static std::vector<TokenBuffer> tokenizeEach(std::vector<Lexer> &lexers, size_t threads);
+        static std::vector<LexedSource> collect(std::vector<Lexer> lexers, size_t threads);
+        static Lexer copyOf(std::string_view content);
+
+        /** Skips whitespace, line terminators and comments, returns whether a line terminator was crossed. */
+        bool skipTrivia();
+        void skipNewlines();
+        void skipLineComment();
+        /** Returns whether the comment contained a line terminator. */
+        bool skipBlockComment();
+        Token lexToken();
+        Token lexString(char quote);
+        /** Cooked UTF-16 value of a string literal body, stored for the lifetime of the lexer. */
+        std::u16string_view decodeString(std::string_view raw);
+        /** Identifier whose first character ends at `firstEnd`. */
+        Token lexIdentifier(size_t firstEnd);
+        /** Decimal (with fraction/exponent, or a leading dot) and hex literals, decoded into Token::number. */
+        Token lexNumber();
+        void skipDigits();
+        Token lexRegex();
+        Token lexOperator();
+        /** One unrecognized character, up to `end`. */
+        Token lexIllegal(size_t end);
+
+        std::shared_ptr<const void> source; /**< Owned copy or file mapping backing `content`, if any. */
+        std::vector<std::unique_ptr<const std::u16string>> strings; /**< Decoded literals, stable across moves. */
+
+        friend std::vector<LexedSource> lexBatch(std::span<const std::string_view> sources, size_t threads);
+        friend std::vector<LexedSource> lexBatch(std::span<const std::filesystem::path> paths, size_t threads);
     };
+
+    /** Tokens of one source of a batch, with the lexer that keeps their text and decoded strings alive. */
+    struct LexedSource {
+        Lexer lexer;
+        TokenBuffer tokens;
+    };
+
+    /**
+     * Tokenizes many sources on `threads` workers (0: one per core). Results are in input order and match
+     * tokenize() on each source; `sources` are borrowed like Lexer(std::string_view).
+     */
+    std::vector<LexedSource> lexBatch(std::span<const std::string_view> sources, size_t threads = 0);
+    /** Same as above for files, mapped like Lexer::fromFile(). */
+    std::vector<LexedSource> lexBatch(std::span<const std::filesystem::path> paths, size_t threads = 0);
 }
 
 #endif //LEXER_HPP
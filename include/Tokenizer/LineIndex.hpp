@@ -0,0 +1,41 @@
+#ifndef LINE_INDEX_HPP
+#define LINE_INDEX_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace Lexer {
+/** 0-based line and column of a byte offset. */
+struct SourceLocation {
+    size_t line;
+    size_t column;
+};
+
+/**
+ * Line-start table for a source, used to turn token offsets into line/column for diagnostics.
+ * The table is only built on the first lookup; lookups are a binary search and safe to call concurrently.
+ * "\n", "\r\n" and a lone "\r" all end a line.
+ */
+class LineIndex {
+public:
+    explicit LineIndex(std::string_view source);
+
+    LineIndex(const LineIndex&) = delete;
+    LineIndex& operator=(const LineIndex&) = delete;
+
+    SourceLocation locate(size_t offset) const;
+
+    size_t lineCount() const;
+
+private:
+    void build() const;
+
+    std::string_view source;
+    mutable std::once_flag built;
+    mutable std::vector<uint32_t> starts;
+};
+}
+
+#endif //LINE_INDEX_HPP
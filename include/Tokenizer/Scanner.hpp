@@ -0,0 +1,45 @@
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * Block scanning kernels used by the lexer hot loops.
+ * Each kernel returns the offset of the first matching byte at or after `from`, or `text.size()`.
+ * SSE2/AVX2 versions are selected at runtime from the CPU features, with a scalar fallback.
+ */
+namespace Lexer::Scan {
+enum class Isa {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+/** Best kernel set supported by this CPU. */
+Isa bestIsa();
+
+Isa activeIsa();
+
+/** Switches the kernel set, returns false if the CPU does not support it. */
+bool useIsa(Isa isa);
+
+const char* isaName(Isa isa);
+
+/** First '\n'. */
+size_t findNewline(std::string_view text, size_t from);
+
+/** First "*\/", returns the offset of the '*'. */
+size_t findCommentEnd(std::string_view text, size_t from);
+
+/** First `quote` or backslash. */
+size_t findQuoteOrBackslash(std::string_view text, size_t from, char quote);
+
+/** First byte that cannot continue an ASCII identifier ([A-Za-z0-9_$]). */
+size_t findNonIdentifier(std::string_view text, size_t from);
+
+/** First byte that is not a space, tab, vertical tab or form feed. */
+size_t findNonSpace(std::string_view text, size_t from);
+}
+
+#endif //SCANNER_HPP
@@ -0,0 +1,88 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Lexer {
+/**
+ * Interned identifier: a 32-bit id into the process-wide SymbolTable.
+ * Equal names always get the same id, so comparing two symbols is an integer compare.
+ * The default symbol (id 0) is the empty name.
+ */
+class Symbol {
+public:
+    Symbol() = default;
+
+    /** Interns `name`, returning the existing symbol if it was seen before. */
+    static Symbol intern(std::string_view name);
+
+    uint32_t id() const {
+        return this->index;
+    }
+
+    bool empty() const {
+        return this->index == 0;
+    }
+
+    /** The interned text, valid for the lifetime of the process. */
+    std::string_view str() const;
+
+    bool operator==(const Symbol& other) const = default;
+
+    friend std::ostream& operator<<(std::ostream& os, Symbol symbol) {
+        return os << symbol.str();
+    }
+
+private:
+    explicit Symbol(uint32_t index) : index(index) {
+    }
+
+    uint32_t index = 0;
+
+    friend class SymbolTable;
+};
+
+/** Process-wide interner behind Symbol. Lookups take a shared lock, only new names take the exclusive one. */
+class SymbolTable {
+public:
+    static SymbolTable& global();
+
+    Symbol intern(std::string_view name);
+
+    std::string_view name(Symbol symbol) const;
+
+    /** Number of distinct names, the empty name included. */
+    size_t size() const;
+
+private:
+    SymbolTable();
+
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> storage; /**< Never relocates its strings, so the views below stay valid. */
+    std::vector<std::string_view> names;
+    std::unordered_map<std::string_view, uint32_t, Hash, std::equal_to<>> ids;
+};
+}
+
+template <>
+struct std::hash<Lexer::Symbol> {
+    size_t operator()(Lexer::Symbol symbol) const noexcept {
+        return std::hash<uint32_t>{}(symbol.id());
+    }
+};
+
+#endif //SYMBOL_HPP
@@ -1,8 +1,11 @@
 #ifndef TOKEN_HPP
 #define TOKEN_HPP
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <array>
+#include <initializer_list>
 
 #define TOKENS(X) \
     X(TK_EOS, nullptr)          /* END OF STREAM */ \
@@ -106,7 +109,6 @@
     X(TK_STRING, nullptr)    /* STRING LITERAL */ \
     X(TK_REGEXP, nullptr)    /* REGEXP LITERAL */ \
     X(TK_IDENTIFIER, nullptr) /* IDENTIFIER */ \
-    X(TK_EOL, "\\n")     /* END OF LINE */ \
     X(TK_SINGLE_LINE_COMMENT, "//") /* SINGLE LINE COMMENT */ \
     X(TK_MULTI_LINE_COMMENT, "/* */") /* MULTI LINE COMMENT */ \
     X(TK_NOT_FOUND, nullptr) /* NOT FOUND */ \
@@ -129,6 +131,68 @@ static constexpr std::array<const char*, TK_NUM_TOKENS + 1> TokenValue = {
     TOKENS(GENERATE_VALUE)
 };
 
+/** Set of token types; membership is one shift and mask of a constant table. */
+class TokenSet {
+public:
+    constexpr TokenSet(std::initializer_list<TokenType> types) {
+        for (const TokenType type : types) {
+            this->words[type / 64] |= std::uint64_t{1} << (type % 64);
+        }
+    }
+
+    constexpr bool contains(TokenType type) const {
+        return (this->words[type / 64] >> (type % 64)) & 1;
+    }
+
+private:
+    std::array<std::uint64_t, TK_NUM_TOKENS / 64 + 1> words{};
+};
+
+/** Lexer dispatch class of a source byte, in the low bits of CharClasses. */
+enum CharClass : std::uint8_t {
+    CC_OTHER = 0,
+    CC_SPACE,
+    CC_NEWLINE,
+    CC_IDENT,
+    CC_DIGIT,
+    CC_QUOTE,
+    CC_SLASH,
+    CC_DOT,
+    CC_PUNCT,
+    CC_UNICODE, /**< Byte of a UTF-8 sequence, classified by the Unicode slow path. */
+    CC_MASK = 0x0f,
+    CC_IDENT_PART = 0x10, /**< Flag: byte may continue an identifier. */
+};
+
+static constexpr std::array<std::uint8_t, 256> CharClasses = [] {
+    std::array<std::uint8_t, 256> classes{};
+    for (size_t i = TK_SIMPLE_OP_FIRST + 1; i < TK_QUAD_OP_LAST; i++) {
+        for (const char* ch = TokenValue[i]; ch != nullptr && *ch != '\0'; ch++) {
+            classes[static_cast<unsigned char>(*ch)] = CC_PUNCT;
+        }
+    }
+    classes[' '] = classes['\t'] = classes['\v'] = classes['\f'] = CC_SPACE;
+    classes['\n'] = classes['\r'] = CC_NEWLINE;
+    classes['\''] = classes['"'] = CC_QUOTE;
+    classes['/'] = CC_SLASH;
+    classes['.'] = CC_DOT;
+    for (int ch = '0'; ch <= '9'; ch++) {
+        classes[ch] = CC_DIGIT | CC_IDENT_PART;
+    }
+    for (int ch = 'a'; ch <= 'z'; ch++) {
+        classes[ch] = classes[ch - 'a' + 'A'] = CC_IDENT | CC_IDENT_PART;
+    }
+    classes['_'] = classes['$'] = CC_IDENT | CC_IDENT_PART;
+    for (int ch = 0x80; ch <= 0xff; ch++) {
+        classes[ch] = CC_UNICODE;
+    }
+    return classes;
+}();
+
+inline CharClass charClass(char ch) {
+    return static_cast<CharClass>(CharClasses[static_cast<unsigned char>(ch)] & CC_MASK);
+}
+
 
 enum Types {
     JS_ANY_REF = 0,
@@ -180,22 +244,45 @@ public:
 
     explicit Token(TokenType type);
 
-    Token(std::string value, TokenType type, unsigned long line, unsigned long column);
+    Token(std::string_view value, TokenType type, uint32_t offset);
+
+    static bool isSkippable(char ch) {
+        return charClass(ch) == CC_SPACE;
+    }
+
+    static bool isSymbolStart(char ch) {
+        return charClass(ch) == CC_IDENT;
+    }
 
-    static bool isSkippable(char ch);
+    static bool isSymbol(char ch) {
+        return (CharClasses[static_cast<unsigned char>(ch)] & CC_IDENT_PART) != 0;
+    }
 
-    static bool isSymbolStart(char ch);
+    static TokenType isKeyword(std::string_view str);
 
-    static bool isSymbol(char ch);
+    static bool isAlpha(std::string_view str);
 
-    static TokenType isKeyword(const std::string& str);
+    /**
+     * Longest-match operator lookup over a compile-time trie of the TOKENS(X) operators.
+     * Returns TK_NOT_FOUND if `str` does not start with an operator, otherwise sets `length`.
+     */
+    static TokenType matchOperator(std::string_view str, size_t& length);
 
-    static bool isAlpha(const std::string& str);
+    /**
+     * Materializes the token text. String literals get the opposite quote
+     * escaped so the result can be emitted inside a double-quoted literal.
+     */
+    std::string str() const;
+    /** Cooked UTF-16 value of a TK_STRING. */
+    std::u16string utf16() const;
 
-    std::string value;
+    std::string_view value; /**< View into the lexed source, valid while the Lexer lives. */
     TokenType type;
-    unsigned long line;
-    unsigned long column;
+    uint32_t offset; /**< Byte offset of the token in the source, see LineIndex for line/column. */
+    bool newlineBefore = false; /**< A line terminator separates this token from the previous one (ASI). */
+    double number = 0; /**< Decoded value of a TK_NUMBER. */
+    /** Decoded TK_STRING value when it differs from `value` (escapes or non-ASCII), null otherwise. */
+    std::u16string_view decoded;
 };
 }
 #endif //TOKEN_HPP
\ No newline at end of file
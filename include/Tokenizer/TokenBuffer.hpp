@@ -0,0 +1,223 @@
+#ifndef TOKEN_BUFFER_HPP
+#define TOKEN_BUFFER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "LineIndex.hpp"
+#include "Token.hpp"
+
+namespace Lexer {
+/**
+ * Compact token storage: one parallel array per field instead of a vector of Token.
+ * Token text is not stored, it is a (start, length) slice of the source the buffer was lexed from,
+ * so the source must outlive the buffer. Indexing materializes a Token view on the fly.
+ * Tokens only carry their byte offset; line/column come from a LineIndex built on the first lookup.
+ * Decoded numbers and strings live in side tables indexed by token, since only a few tokens need them.
+ */
+class TokenBuffer {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Token;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Token;
+
+        Iterator(const TokenBuffer* buffer, size_t index) : buffer(buffer), index(index) {
+        }
+
+        Token operator*() const {
+            return (*this->buffer)[this->index];
+        }
+
+        Iterator& operator++() {
+            this->index++;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            this->index++;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const = default;
+
+    private:
+        const TokenBuffer* buffer;
+        size_t index;
+    };
+
+    TokenBuffer();
+    explicit TokenBuffer(std::string_view source);
+
+    /** Rough token count for `bytes` of source, used to pre-reserve the arrays. */
+    static size_t estimateTokens(size_t bytes);
+
+    void reserve(size_t count);
+
+    /** Appends a token whose value is a view into this buffer's source. */
+    void push(const Token& token);
+
+    /** Appends tokens `from..` of a buffer lexed from the same source. */
+    void append(const TokenBuffer& other, size_t from);
+
+    /** Index of the token starting at byte `offset`, or size() if no token starts there. */
+    size_t find(uint32_t offset) const;
+
+    /**
+     * Rebases the buffer on the edited `source`: tokens [first, last) are replaced by `replacement`
+     * (lexed from `source`) and the tokens after them move by `delta` bytes.
+     * Costs O(tokens after `last`): their starts are shifted, and the arrays move once when the token count
+     * changes. That is 1-2 ms for an edit at the top of an 8 MB file; the line index is rebuilt lazily.
+     */
+    void splice(size_t first, size_t last, const TokenBuffer& replacement, std::string_view source, ptrdiff_t delta);
+
+    /** Materialized token, or a TK_EOS token at the end of the source past the last token. */
+    Token operator[](size_t index) const {
+        if (index >= this->types.size()) {
+            return {this->text.substr(this->text.size()), TK_EOS, static_cast<uint32_t>(this->text.size())};
+        }
+        Token token(
+            this->text.substr(this->starts[index], this->lengths[index]),
+            static_cast<TokenType>(this->types[index] & TYPE_MASK),
+            this->starts[index]
+        );
+        token.newlineBefore = (this->types[index] & NEWLINE_BEFORE) != 0;
+        if (token.type == TK_NUMBER) {
+            token.number = this->number(index);
+        } else if (token.type == TK_STRING) {
+            token.decoded = this->decoded(index);
+        }
+        return token;
+    }
+
+    Token back() const {
+        return (*this)[this->types.size() - 1];
+    }
+
+    TokenType type(size_t index) const {
+        return index < this->types.size() ? static_cast<TokenType>(this->types[index] & TYPE_MASK) : TK_EOS;
+    }
+
+    bool newlineBefore(size_t index) const {
+        return index < this->types.size() && (this->types[index] & NEWLINE_BEFORE) != 0;
+    }
+
+    /** Decoded value of the TK_NUMBER at `index`. */
+    double number(size_t index) const {
+        return this->numbers.find(index, 0.0);
+    }
+
+    /** Decoded value of the TK_STRING at `index`, or a null view if it is the raw text. */
+    std::u16string_view decoded(size_t index) const {
+        return this->strings.find(index, std::u16string_view());
+    }
+
+    uint32_t start(size_t index) const {
+        return this->starts[index];
+    }
+
+    uint32_t length(size_t index) const {
+        return this->lengths[index];
+    }
+
+    size_t size() const {
+        return this->types.size();
+    }
+
+    bool empty() const {
+        return this->types.empty();
+    }
+
+    std::string_view source() const {
+        return this->text;
+    }
+
+    /** Line and column of a byte offset in the source. */
+    SourceLocation location(size_t offset) const {
+        return this->lineIndex->locate(offset);
+    }
+
+    SourceLocation location(const Token& token) const {
+        return this->lineIndex->locate(token.offset);
+    }
+
+    Iterator begin() const {
+        return {this, 0};
+    }
+
+    Iterator end() const {
+        return {this, this->types.size()};
+    }
+
+private:
+    /** The type byte keeps the newline-before flag in its top bit. */
+    static constexpr uint8_t NEWLINE_BEFORE = 0x80;
+    static constexpr uint8_t TYPE_MASK = 0x7f;
+    static_assert(TK_NUM_TOKENS <= TYPE_MASK, "token types must leave the flag bit free");
+
+    std::string_view text;
+    std::vector<uint8_t> types;
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> lengths;
+    /** Values attached to a few tokens, keyed by ascending token index. */
+    template <typename T>
+    struct SideTable {
+        std::vector<uint32_t> indices;
+        std::vector<T> values;
+
+        T find(size_t index, T fallback) const {
+            auto it = std::lower_bound(this->indices.begin(), this->indices.end(), index);
+            return it != this->indices.end() && *it == index ? this->values[it - this->indices.begin()] : fallback;
+        }
+
+        /** Replaces the entries of tokens [first, last) by those of `other`'s `count` tokens, renumbering the ones after. */
+        void splice(size_t first, size_t last, const SideTable& other, size_t count) {
+            auto begin = std::lower_bound(this->indices.begin(), this->indices.end(), first);
+            auto end = std::lower_bound(begin, this->indices.end(), last);
+            const size_t at = begin - this->indices.begin();
+            const size_t removed = end - begin;
+            const ptrdiff_t shift = static_cast<ptrdiff_t>(count) - static_cast<ptrdiff_t>(last - first);
+            if (shift != 0) {
+                for (auto it = end; it != this->indices.end(); ++it) {
+                    *it = static_cast<uint32_t>(*it + shift);
+                }
+            }
+            // Resize the range in place, so that the entries after it move at most once.
+            const size_t added = other.indices.size();
+            if (added > removed) {
+                this->indices.insert(this->indices.begin() + at + removed, added - removed, 0);
+                this->values.insert(this->values.begin() + at + removed, added - removed, T());
+            } else {
+                this->indices.erase(this->indices.begin() + at + added, this->indices.begin() + at + removed);
+                this->values.erase(this->values.begin() + at + added, this->values.begin() + at + removed);
+            }
+            for (size_t i = 0; i < added; i++) {
+                this->indices[at + i] = static_cast<uint32_t>(other.indices[i] + first);
+            }
+            std::copy(other.values.begin(), other.values.end(), this->values.begin() + at);
+        }
+
+        /** Appends the entries of `other` from token `from` on, renumbered to start at token `shift`. */
+        void append(const SideTable& other, size_t from, size_t shift) {
+            auto it = std::lower_bound(other.indices.begin(), other.indices.end(), from);
+            for (; it != other.indices.end(); ++it) {
+                this->indices.push_back(static_cast<uint32_t>(shift + (*it - from)));
+                this->values.push_back(other.values[it - other.indices.begin()]);
+            }
+        }
+    };
+
+    SideTable<double> numbers;
+    SideTable<std::u16string_view> strings;
+    std::shared_ptr<const LineIndex> lineIndex;
+};
+}
+
+#endif //TOKEN_BUFFER_HPP
@@ -0,0 +1,58 @@
+#ifndef TOKEN_STREAM_HPP
+#define TOKEN_STREAM_HPP
+
+#include <memory>
+#include <vector>
+#include "LineIndex.hpp"
+#include "Token.hpp"
+#include "TokenBuffer.hpp"
+
+namespace Lexer {
+class Lexer;
+
+/**
+ * Token source for the parser, indexed by absolute token position.
+ * Either replays a TokenBuffer, or pulls tokens from a Lexer on demand into a ring buffer that keeps
+ * the last `window` tokens, so token memory stays bounded by the lookahead/backtracking window
+ * instead of the file size. Reading past TK_EOS keeps returning the TK_EOS token.
+ */
+class TokenStream {
+public:
+    static constexpr size_t DEFAULT_WINDOW = 1024;
+
+    explicit TokenStream(const TokenBuffer& tokens);
+    /** The lexer must outlive the stream. `window` is rounded up to a power of two. */
+    explicit TokenStream(Lexer& lexer, size_t window = DEFAULT_WINDOW);
+
+    /** Token at `index`, lexing forward as needed. Throws std::out_of_range if it already left the window. */
+    Token at(size_t index) const;
+
+    /** Type of the token at `index` without materializing it; same rules as at(). */
+    TokenType type(size_t index) const {
+        return this->buffer != nullptr ? this->buffer->type(index) : this->at(index).type;
+    }
+
+    bool newlineBefore(size_t index) const {
+        return this->buffer != nullptr ? this->buffer->newlineBefore(index) : this->at(index).newlineBefore;
+    }
+
+    /** Whether `index` can still be read, i.e. it is ahead of the stream or inside the window. */
+    bool retains(size_t index) const;
+
+    SourceLocation location(const Token& token) const;
+
+private:
+    void fill(size_t index) const;
+
+    const TokenBuffer* buffer = nullptr;
+    Lexer* lexer = nullptr;
+    std::shared_ptr<const LineIndex> lineIndex;
+
+    // Lazily filled, hence mutable: reading a token is logically const.
+    mutable std::vector<Token> ring;
+    mutable size_t produced = 0;
+    mutable bool ended = false;
+};
+}
+
+#endif //TOKEN_STREAM_HPP
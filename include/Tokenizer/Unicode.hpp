@@ -0,0 +1,32 @@
+#ifndef UNICODE_HPP
+#define UNICODE_HPP
+
+#include <string>
+#include <string_view>
+
+/**
+ * Unicode classification for the lexer's slow path, only reached once a byte >= 0x80 is seen.
+ * Backed by range tables generated by scripts/generate_unicode_tables.py.
+ */
+namespace Lexer::Unicode {
+/** ES5 IdentifierStart letters (Lu, Ll, Lt, Lm, Lo, Nl). */
+bool isIdStart(char32_t point);
+
+/** ES5 IdentifierPart: IdentifierStart plus Mn, Mc, Nd, Pc, ZWNJ and ZWJ. */
+bool isIdPart(char32_t point);
+
+/** ES5 WhiteSpace: Zs, NBSP and BOM (ASCII spaces included). */
+bool isSpace(char32_t point);
+
+/** LS and PS, the non-ASCII line terminators. */
+inline bool isLineTerminator(char32_t point) {
+    return point == 0x2028 || point == 0x2029;
+}
+
+/** Decodes the UTF-8 sequence at `i` and moves past it; malformed input gives U+FFFD and skips one byte. */
+char32_t decodeUtf8(std::string_view text, size_t& i);
+
+void appendUtf16(std::u16string& out, char32_t point);
+}
+
+#endif //UNICODE_HPP
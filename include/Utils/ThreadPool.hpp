@@ -0,0 +1,71 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Lexer::Utils {
+/**
+ * Fixed-size pool of worker threads, each with its own task deque. Workers run their newest task first and
+ * steal the oldest task of another worker when theirs is empty, so uneven tasks keep every worker busy
+ * without all of them contending on one queue.
+ */
+class ThreadPool {
+public:
+    /** `threads == 0` uses one worker per hardware thread. */
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const {
+        return this->workers.size();
+    }
+
+    /**
+     * Queues `task` on the calling worker's deque, or spreads it round-robin when called from outside the
+     * pool; the future rethrows anything the task throws.
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F task) {
+        using Result = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> future = packaged->get_future();
+        this->enqueue([packaged] { (*packaged)(); });
+        return future;
+    }
+
+    /** Number of workers used when none is requested. */
+    static size_t defaultThreads();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void enqueue(std::function<void()> task);
+    /** Pops the newest task of worker `index`, or steals the oldest one of another worker. */
+    bool take(size_t index, std::function<void()>& task);
+    void run(size_t index);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> nextQueue = 0;
+    std::atomic<size_t> pending = 0; /**< Tasks queued but not taken yet. */
+    std::mutex mutex; /**< Guards sleeping; `pending` only grows and `stopping` only changes under it. */
+    std::condition_variable ready;
+    bool stopping = false;
+};
+}
+
+#endif //THREAD_POOL_HPP
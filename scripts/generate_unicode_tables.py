@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""Generates src/Tokenizer/UnicodeTables.inc, the non-ASCII ES5 identifier and whitespace range tables.
+
+ES5 7.6: IdentifierStart is a UnicodeLetter (Lu, Ll, Lt, Lm, Lo, Nl), IdentifierPart adds
+Mn, Mc, Nd, Pc, ZWNJ and ZWJ. ES5 7.2: WhiteSpace is Zs plus TAB, VT, FF, SP, NBSP and BOM.
+ASCII is classified by the lexer's CharClasses table, so only code points >= 0x80 are emitted.
+
+Usage: python3 scripts/generate_unicode_tables.py > src/Tokenizer/UnicodeTables.inc
+"""
+import sys
+import unicodedata
+
+ID_START = {"Lu", "Ll", "Lt", "Lm", "Lo", "Nl"}
+ID_PART = ID_START | {"Mn", "Mc", "Nd", "Pc"}
+
+
+def ranges(predicate):
+    out = []
+    for cp in range(0x80, sys.maxunicode + 1):
+        if predicate(cp):
+            if out and out[-1][1] == cp - 1:
+                out[-1][1] = cp
+            else:
+                out.append([cp, cp])
+    return out
+
+
+def emit(name, table):
+    print(f"constexpr Range {name}[] = {{")
+    for i in range(0, len(table), 4):
+        row = ", ".join(f"{{0x{a:04X}, 0x{b:04X}}}" for a, b in table[i:i + 4])
+        print(f"    {row},")
+    print("};")
+    print()
+
+
+def main():
+    category = unicodedata.category
+    print(f"// Generated by scripts/generate_unicode_tables.py from Unicode {unicodedata.unidata_version}. Do not edit.")
+    print()
+    emit("ID_START", ranges(lambda cp: category(chr(cp)) in ID_START))
+    emit("ID_PART", ranges(lambda cp: category(chr(cp)) in ID_PART or cp in (0x200C, 0x200D)))
+    emit("SPACE", ranges(lambda cp: category(chr(cp)) == "Zs" or cp in (0xA0, 0xFEFF)))
+
+
+if __name__ == "__main__":
+    main()
@@ -278,6 +278,10 @@ void EmptyStmt::print(size_t indent) const {
     std::cout << std::string(indent, ' ') << "EmptyStmt\n";
 }
 
+void ErrorStmt::print(size_t indent) const {
+    std::cout << std::string(indent, ' ') << "ErrorStmt\n";
+}
+
 void FunctionDecl::print(size_t indent) const {
     std::cout << std::string(indent, ' ') << "FunctionDecl(" << name << ")\n";
     std::cout << std::string(indent + 2, ' ') << "Params:\n";
@@ -1,16 +1,58 @@
 #include "../../include/AST/AST.hpp"
 
+#include <string_view>
 #include <unordered_map>
 
 namespace Lexer::AST {
 
+/** Writes UTF-16 code units as the body of a C++ u"..." literal. */
+static void writeUtf16(std::ostringstream& os, std::u16string_view text) {
+    static constexpr char HEX[] = "0123456789ABCDEF";
+    auto hex = [&os](char32_t value, int digits) {
+        for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+            os << HEX[(value >> shift) & 0xf];
+        }
+    };
+    for (size_t i = 0; i < text.size(); i++) {
+        const char16_t unit = text[i];
+        if (unit == u'"' || unit == u'\\') {
+            os << '\\' << static_cast<char>(unit);
+        } else if (unit == u'\n') {
+            os << "\\n";
+        } else if (unit == u'\t') {
+            os << "\\t";
+        } else if (unit == u'\r') {
+            os << "\\r";
+        } else if (unit >= 0x20 && unit < 0x7f) {
+            os << static_cast<char>(unit);
+        } else if (unit < 0x20 || unit == 0x7f) {
+            os << '\\' << static_cast<char>('0' + (unit >> 6)) << static_cast<char>('0' + ((unit >> 3) & 7))
+               << static_cast<char>('0' + (unit & 7));
+        } else if (unit >= 0xd800 && unit < 0xdc00 && i + 1 < text.size() && text[i + 1] >= 0xdc00 && text[i + 1] < 0xe000) {
+            os << "\\U";
+            hex(0x10000 + ((unit - 0xd800) << 10) + (text[++i] - 0xdc00), 8);
+        } else if (unit >= 0xd800 && unit < 0xe000) {
+            // A lone surrogate cannot be a universal character name; emit the raw unit and restart the literal
+            // so following hex digits are not absorbed by the escape.
+            os << "\\x";
+            hex(unit, 4);
+            os << "\" u\"";
+        } else {
+            os << "\\u";
+            hex(unit, 4);
+        }
+    }
+}
+
 std::ostringstream& Number::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
     os << "JS::Any(" << value << ")";
     return os;
 }
 
 std::ostringstream& String::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
-    os << "JS::Any(u\"" << value << "\")";
+    os << "JS::Any(u\"";
+    writeUtf16(os, utf16);
+    os << "\")";
     return os;
 }
 
@@ -36,7 +78,7 @@ std::ostringstream& This::transpile(std::ostringstream& os, std::ostringstream&
 
 
 std::ostringstream& RegularExpression::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
-    std::string pattern = value;
+    std::string pattern(value);
     std::string flags;
     size_t lastSlash = pattern.rfind('/');
     if (lastSlash != std::string::npos && lastSlash > 0) {
@@ -89,7 +131,7 @@ std::ostringstream& Grouped::transpile(std::ostringstream& os, std::ostringstrea
 }
 
 std::ostringstream& BinaryExpr::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
-    static const std::unordered_map<std::string, std::string> opMap = {
+    static const std::unordered_map<std::string_view, std::string_view> opMap = {
         {"===", "strictEq"}, {"!==", "strictNeq"}, {">>>", "URightShift"},
     };
     left->transpile(os, vars, indent);
@@ -99,7 +141,7 @@ std::ostringstream& BinaryExpr::transpile(std::ostringstream& os, std::ostringst
 }
 
 std::ostringstream& AssignementExpr::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
-    static const std::unordered_map<std::string, std::string> opMap = {
+    static const std::unordered_map<std::string_view, std::string_view> opMap = {
         {">>>=", "URightShift"}, {"<<=", "<<"}, {">>=", ">>"},
         {"+=", "+"}, {"-=", "-"}, {"*=", "*"}, {"/=", "/"}, {"%=", "%"},
         {"&=", "&"}, {"|=", "|"}, {"^=", "^"},
@@ -116,7 +158,7 @@ std::ostringstream& AssignementExpr::transpile(std::ostringstream& os, std::ostr
 }
 
 std::ostringstream& UnaryExpr::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
-    static const std::unordered_map<std::string, std::string> opMap = {
+    static const std::unordered_map<std::string_view, std::string_view> opMap = {
         {"typeof", "typeOf"}, {"delete", "del"}, {"void", "Void"},
     };
     if (op == "void")
@@ -163,7 +205,7 @@ std::ostringstream& NewExpr::transpile(std::ostringstream& os, std::ostringstrea
 std::ostringstream& MemberExpr::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
     object->transpile(os, vars, indent);
     if (computed) {
-        std::string identifier = dynamic_cast<Identifier*>(property.get()) ? dynamic_cast<Identifier*>(property.get())->name : "";
+        std::string identifier = dynamic_cast<Identifier*>(property.get()) ? std::string(dynamic_cast<Identifier*>(property.get())->name.str()) : "";
         os << "[u\"" << identifier << "\"]";
     } else {
         os << "[";
@@ -192,7 +234,7 @@ std::ostringstream& FunctionExpr::transpile(std::ostringstream& os, std::ostring
     }
     body->transpile(os, vars, indent + 4);
     os << std::string(indent + 4, ' ') << "return JS::Any();\n";
-    os << std::string(indent, ' ') << "}, " << params.size() << ", u\"" << (name.empty() ? "anonymous" : name) << "\"))";
+    os << std::string(indent, ' ') << "}, " << params.size() << ", u\"" << (name.empty() ? std::string_view("anonymous") : name.str()) << "\"))";
     return os;
 }
 
@@ -393,6 +435,10 @@ std::ostringstream& EmptyStmt::transpile(std::ostringstream& os, std::ostringstr
     return os;
 }
 
+std::ostringstream& ErrorStmt::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
+    throw std::runtime_error("a statement with a syntax error cannot be transpiled - check the parser diagnostics.");
+}
+
 std::ostringstream& ThrowStmt::transpile(std::ostringstream& os, std::ostringstream& vars, size_t indent) const {
     os << std::string(indent, ' ') << "throw ";
     argument->transpile(os, vars, indent);
@@ -428,7 +474,7 @@ std::ostringstream& FunctionDecl::transpile(std::ostringstream& os, std::ostring
     }
     body->transpile(os, vars, indent + 4);
     os << std::string(indent + 4, ' ') << "return JS::Any();\n";
-    os << std::string(indent, ' ') << "}, " << params.size() << ", u\"" << (name.empty() ? "anonymous" : name) << "\"));\n";
+    os << std::string(indent, ' ') << "}, " << params.size() << ", u\"" << (name.empty() ? std::string_view("anonymous") : name.str()) << "\"));\n";
     return os;
 }
 
@@ -0,0 +1,48 @@
+#include "../../include/AST/Arena.hpp"
+
+#include <algorithm>
+
+Lexer::AST::Arena::Arena(size_t firstBlock)
+    : firstBlock(std::max<size_t>(firstBlock, 64)) {
+}
+
+void Lexer::AST::Arena::reset() {
+    this->current = 0;
+    this->offset = 0;
+    this->usedBefore = 0;
+}
+
+size_t Lexer::AST::Arena::used() const {
+    return this->usedBefore + this->offset;
+}
+
+size_t Lexer::AST::Arena::capacity() const {
+    size_t total = 0;
+    for (const Block& block : this->blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void* Lexer::AST::Arena::do_allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        if (this->current < this->blocks.size()) {
+            Block& block = this->blocks[this->current];
+            void* address = block.data.get() + this->offset;
+            size_t space = block.size - this->offset;
+            if (std::align(alignment, bytes, address, space) != nullptr) {
+                this->offset = block.size - space + bytes;
+                return address;
+            }
+            // Leave the tail of a full block unused; retained blocks are tried in order after a reset.
+            this->usedBefore += this->offset;
+            this->current++;
+            this->offset = 0;
+            continue;
+        }
+        // Each new block doubles the last one, so a unit needs O(log size) of them.
+        size_t size = this->blocks.empty() ? this->firstBlock : this->blocks.back().size * 2;
+        size = std::max(size, bytes + alignment);
+        this->blocks.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});
+    }
+}
@@ -0,0 +1,13 @@
+#include "../../include/AST/FunctionBody.hpp"
+#include "../../include/AST/AST.hpp"
+#include "../../include/AST/Parser.hpp"
+
+const Lexer::AST::Stmt::Ptr& Lexer::AST::FunctionBody::get() const {
+    if (this->body == nullptr) {
+        Parser parser(*this->tokens, *this->arena, this->flags);
+        parser.setDepthLimit(this->depthLimit);
+        parser.cursor = this->begin;
+        this->body = BlockStmt::parse(parser);
+    }
+    return this->body;
+}
@@ -1,23 +1,147 @@
 #include "../../include/AST/Parser.hpp"
 #include "../../include/AST/AST.hpp"
+#include "../../include/Utils/ThreadPool.hpp"
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <tuple>
 
 namespace Lexer::AST {
-
+namespace {
+constexpr TokenSet MEMBER_ACCESS = {TK_PERIOD, TK_LBRACK};
+constexpr TokenSet UPDATE_OPERATORS = {TK_INC, TK_DEC};
+constexpr TokenSet UNARY_OPERATORS = {TK_INC, TK_DEC, TK_DELETE, TK_VOID, TK_TYPEOF, TK_ADD, TK_SUB, TK_BIT_NOT, TK_NOT};
+/** Keywords that start a statement; recovery resumes at one that begins a line. */
+constexpr TokenSet STATEMENT_KEYWORDS = {
+    TK_VAR, TK_IF, TK_FOR, TK_WHILE, TK_DO, TK_FUNCTION, TK_RETURN, TK_BREAK, TK_CONTINUE, TK_SWITCH, TK_THROW,
+    TK_TRY, TK_WITH, TK_DEBUGGER,
+};
+constexpr TokenSet ASSIGNMENT_OPERATORS = {
+    TK_ASSIGN, TK_ASSIGN_ADD, TK_ASSIGN_SUB, TK_ASSIGN_MUL, TK_ASSIGN_DIV, TK_ASSIGN_MOD,
+    TK_ASSIGN_BIT_AND, TK_ASSIGN_BIT_OR, TK_ASSIGN_BIT_XOR, TK_ASSIGN_SAR, TK_ASSIGN_SHL, TK_ASSIGN_SHR,
+};
+
+/** Binding power of every binary operator below the conditional, 0 for any other token; higher binds tighter. */
+constexpr std::array<uint8_t, TK_NUM_TOKENS + 1> BINARY_POWER = [] {
+    std::array<uint8_t, TK_NUM_TOKENS + 1> power{};
+    power[TK_LOGICAL_OR] = 1;
+    power[TK_LOGICAL_AND] = 2;
+    power[TK_BIT_OR] = 3;
+    power[TK_BIT_XOR] = 4;
+    power[TK_BIT_AND] = 5;
+    for (TokenType type : {TK_EQ, TK_NE, TK_EQ_STRICT, TK_NE_STRICT}) {
+        power[type] = 6;
+    }
+    for (TokenType type : {TK_LT, TK_GT, TK_LTE, TK_GTE, TK_IN, TK_INSTANCEOF}) {
+        power[type] = 7;
+    }
+    for (TokenType type : {TK_SAR, TK_SHL, TK_SHR}) {
+        power[type] = 8;
+    }
+    for (TokenType type : {TK_ADD, TK_SUB}) {
+        power[type] = 9;
+    }
+    for (TokenType type : {TK_MUL, TK_DIV, TK_MOD}) {
+        power[type] = 10;
+    }
+    return power;
+}();
+}
 
 Stmt::Ptr Parser::parseStatement() {
-    skipEols();
-    if (this->isAtEnd()) {
-        return EmptyStmt::parse(*this);
+    if ((flags & PARSE_EXPLICIT_STACK) != 0) {
+        return parseStatementIteratively();
+    }
+    if ((flags & PARSE_RECOVER) != 0) {
+        const size_t start = cursor;
+        try {
+            DepthGuard guard(*this);
+            return dispatchStatement();
+        } catch (const ParseError& error) {
+            return recover(error, start);
+        }
     }
-    if (match(TK_IDENTIFIER)) {
-        if (check(TK_COLON)) {
-            reverse();
-            return LabeledStmt::parse(*this);
+    DepthGuard guard(*this);
+    return dispatchStatement();
+}
+
+Stmt::Ptr Parser::recover(const ParseError& error, size_t start) {
+    errors.push_back({error, cursor});
+    if (cursor == start && !isAtEnd()) {
+        // A token that cannot start a statement, such as a stray '}', is dropped on its own.
+        advance();
+    } else {
+        skipStatement(start);
+    }
+    return ErrorStmt::parse(*this);
+}
+
+void Parser::skipStatement(size_t start) {
+    // The brackets the statement opened before the error are still open, and a ';' inside them, as in a for
+    // header, does not end it.
+    closers.clear();
+    auto bracket = [this](TokenType type) {
+        switch (type) {
+            case TK_LBRACE:
+                closers.push_back(TK_RBRACE);
+                return true;
+            case TK_LPAREN:
+                closers.push_back(TK_RPAREN);
+                return true;
+            case TK_LBRACK:
+                closers.push_back(TK_RBRACK);
+                return true;
+            case TK_RBRACE:
+            case TK_RPAREN:
+            case TK_RBRACK: {
+                auto open = std::find(closers.rbegin(), closers.rend(), type);
+                if (open == closers.rend()) {
+                    return false;
+                }
+                closers.erase(std::prev(open.base()), closers.end());
+                return true;
+            }
+            default:
+                return true;
+        }
+    };
+    for (size_t i = start; i < cursor; i++) {
+        bracket(tokens.type(i));
+    }
+
+    // Stops past a ';' or after a '}' ending a line at the statement's own level, or before a '}' of an enclosing
+    // block. A statement keyword starting a line ends it at any level, as the bracket is more likely left open.
+    while (!isAtEnd()) {
+        const TokenType type = tokens.type(cursor);
+        const bool newline = tokens.newlineBefore(cursor);
+        if (newline && STATEMENT_KEYWORDS.contains(type)) {
+            return;
+        }
+        if (closers.empty()) {
+            if (type == TK_SEMICOLON) {
+                cursor++;
+                return;
+            }
+            if (newline && cursor > start && tokens.type(cursor - 1) == TK_RBRACE) {
+                return;
+            }
         }
-        reverse();
+        if (!bracket(type) && type == TK_RBRACE) {
+            return;
+        }
+        cursor++;
+    }
+}
+
+Stmt::Ptr Parser::dispatchStatement() {
+    if (this->isAtEnd()) {
+        return EmptyStmt::parse(*this);
     }
 
     switch (peek().type) {
@@ -51,11 +175,179 @@ Stmt::Ptr Parser::parseStatement() {
             return DebuggerStmt::parse(*this);
         case TK_LBRACE:
             return BlockStmt::parse(*this);
+        case TK_IDENTIFIER:
+            return parseExpressionOrLabel();
         default:
             return ExpressionStmt::parse(*this);
     }
 }
 
+Program Parser::parseProgram(size_t threads) {
+    Program program;
+    if (buffer == nullptr) {
+        while (!isAtEnd()) {
+            program.statements.push_back(parseStatement());
+        }
+        return program;
+    }
+
+    Outline outline;
+    const flag_t saved = flags;
+    flags |= PARSE_LAZY_FUNCTIONS;
+    deferred = &outline.bodies;
+    try {
+        while (!isAtEnd()) {
+            program.statements.push_back(parseStatement());
+        }
+    } catch (const ParseError&) {
+        // Bodies skipped before the error may hold an earlier one, so they are still built.
+        outline.fail(cursor);
+    }
+    flags = saved;
+    deferred = nullptr;
+
+    if (threads == 0) {
+        threads = Utils::ThreadPool::defaultThreads();
+    }
+    std::vector<FunctionBody*> level = std::move(outline.bodies);
+    std::vector<Outline> workers;
+    // Declared last so that it drains its tasks before anything they reference goes away.
+    std::optional<Utils::ThreadPool> pool;
+    while (!level.empty()) {
+        const size_t count = std::min(threads, level.size());
+        while (program.arenas.size() < count) {
+            program.arenas.push_back(std::make_unique<Arena>());
+        }
+        workers.assign(count, Outline());
+        std::atomic<size_t> next = 0;
+        auto work = [&](size_t worker) {
+            for (size_t i = next++; i < level.size(); i = next++) {
+                buildBody(*level[i], *program.arenas[worker], workers[worker]);
+            }
+        };
+        if (count < 2) {
+            work(0);
+        } else {
+            if (!pool) {
+                pool.emplace(threads);
+            }
+            std::vector<std::future<void>> tasks;
+            for (size_t worker = 0; worker < count; worker++) {
+                tasks.push_back(pool->submit([&work, worker] { work(worker); }));
+            }
+            for (std::future<void>& task : tasks) {
+                task.wait();
+            }
+            for (std::future<void>& task : tasks) {
+                task.get();
+            }
+        }
+
+        level.clear();
+        for (Outline& worker : workers) {
+            level.insert(level.end(), worker.bodies.begin(), worker.bodies.end());
+            outline.merge(worker);
+        }
+        // Which worker found a body depends on scheduling; building them in source order does not.
+        std::ranges::sort(level, {}, &FunctionBody::firstToken);
+    }
+    if (outline.error) {
+        std::rethrow_exception(outline.error);
+    }
+    // Bodies were skipped by the parser that deferred them, so ordering by token interleaves them correctly.
+    errors.insert(errors.end(), outline.diagnostics.begin(), outline.diagnostics.end());
+    std::ranges::stable_sort(errors, {}, &Diagnostic::token);
+    return program;
+}
+
+void Parser::Outline::fail(size_t at) {
+    if (at < errorAt) {
+        error = std::current_exception();
+        errorAt = at;
+    }
+}
+
+void Parser::Outline::merge(Outline& other) {
+    diagnostics.insert(diagnostics.end(), other.diagnostics.begin(), other.diagnostics.end());
+    if (other.errorAt < errorAt) {
+        error = std::move(other.error);
+        errorAt = other.errorAt;
+    }
+}
+
+void Parser::buildBody(FunctionBody& body, Arena& arena, Outline& outline) {
+    Parser parser(*body.tokens, arena, body.flags | PARSE_LAZY_FUNCTIONS);
+    parser.setDepthLimit(body.depthLimit);
+    parser.cursor = body.begin;
+    parser.deferred = &outline.bodies;
+    try {
+        body.body = BlockStmt::parse(parser);
+    } catch (const ParseError&) {
+        outline.fail(parser.cursor);
+    }
+    outline.diagnostics.insert(outline.diagnostics.end(), parser.errors.begin(), parser.errors.end());
+}
+
+FunctionBody Parser::parseFunctionBody() {
+    // A deferred body could only report its diagnostics to parseProgram().
+    if ((flags & PARSE_LAZY_FUNCTIONS) == 0 || buffer == nullptr || ((flags & PARSE_RECOVER) != 0 && deferred == nullptr)) {
+        return FunctionBody(BlockStmt::parse(*this));
+    }
+    const size_t begin = cursor;
+    skipBlock();
+    return FunctionBody(*buffer, arena, begin, flags, depthLimit);
+}
+
+void Parser::skipBlock() {
+    consume(TK_LBRACE, "BlockStmt", "Expected '{' at start of block.");
+    closers.clear();
+    while (true) {
+        const TokenType type = tokens.type(cursor);
+        switch (type) {
+            case TK_LBRACE:
+                closers.push_back(TK_RBRACE);
+                break;
+            case TK_LPAREN:
+                closers.push_back(TK_RPAREN);
+                break;
+            case TK_LBRACK:
+                closers.push_back(TK_RBRACK);
+                break;
+            case TK_RBRACE:
+            case TK_RPAREN:
+            case TK_RBRACK:
+                if (closers.empty() && type == TK_RBRACE) {
+                    cursor++;
+                    match(TK_SEMICOLON); // optional semicolon after block, as in BlockStmt::parse
+                    return;
+                }
+                if (closers.empty() || closers.back() != type) {
+                    fail("BlockStmt", "Unbalanced bracket in function body.");
+                }
+                closers.pop_back();
+                break;
+            case TK_ILLEGAL:
+                fail("BlockStmt", "Unexpected token in function body.");
+            case TK_EOS:
+                fail("BlockStmt", "Expected '}' at end of block.");
+            default:
+                break;
+        }
+        cursor++;
+    }
+}
+
+Stmt::Ptr Parser::parseExpressionOrLabel() {
+    // A label is only known once the ':' shows up, so parse the expression first and reinterpret it.
+    Expr::Ptr expr = parseExpression();
+    if (auto* label = dynamic_cast<Identifier*>(expr.get()); label != nullptr && match(TK_COLON)) {
+        Stmt::Ptr body = parseStatement();
+        return this->make<LabeledStmt>(label->name, std::move(body));
+    }
+    expectSemicolon("ExpressionStmt", "Expected ';' after expression.");
+    return this->make<ExpressionStmt>(std::move(expr));
+}
+
 Expr::Ptr Parser::parsePrimary() {
     switch (peek().type) {
         case TK_THIS:
@@ -84,7 +376,7 @@ Expr::Ptr Parser::parsePrimary() {
         case TK_LPAREN:
             return Grouped::parse(*this);
         default:
-            throw ParseError("Unexpected token in primary expression: " + peek().value + " of type " + TokenName[peek().type] + " at line " + std::to_string(peek().line) + " col " + std::to_string(peek().column) + ".");
+            throw ParseError("Unexpected token in primary expression: " + std::string(peek().value) + " of type " + TokenName[peek().type] + " at " + position(peek()) + ".");
     }
 }
 
@@ -96,7 +388,7 @@ Expr::Ptr Parser::parseNewOrMember() {
         expr = parsePrimary();
     }
     while (true) {
-        if (match(TK_PERIOD) || match(TK_LBRACK)) {
+        if (matchAny(MEMBER_ACCESS)) {
             expr = MemberExpr::parse(*this, std::move(expr));
         } else {
             break;
@@ -108,9 +400,12 @@ Expr::Ptr Parser::parseNewOrMember() {
 }
 
 Expr::Ptr Parser::parseLeftHandSide() {
+    if ((flags & PARSE_EXPLICIT_STACK) != 0) {
+        return parseExpressionIteratively(ExprStep::LEFT_HAND_SIDE, false);
+    }
     Expr::Ptr expr = parseNewOrMember();
     while (true) {
-        if (match(TK_PERIOD) || match(TK_LBRACK)) {
+        if (matchAny(MEMBER_ACCESS)) {
             expr = MemberExpr::parse(*this, std::move(expr));
         } else if (match(TK_LPAREN)) {
             expr = CallExpr::parse(*this, std::move(expr));
@@ -128,13 +423,14 @@ Expr::Ptr Parser::parsePostfix() {
         return expr;
     }
 
-    if (match(TK_INC) || match(TK_DEC)) {
+    if (matchAny(UPDATE_OPERATORS)) {
         expr = PostfixExpr::parse(*this, std::move(expr));
     }
     return expr;
 }
 
 Expr::Ptr Parser::parseUnary() {
+    DepthGuard guard(*this);
     switch (peek().type) {
         case TK_INC:
         case TK_DEC:
@@ -152,141 +448,492 @@ Expr::Ptr Parser::parseUnary() {
     }
 }
 
-Expr::Ptr Parser::parseMultiplicative() {
+Expr::Ptr Parser::parseBinary(uint8_t minPower, bool noIn) {
+    // Precedence climbing: an operator binding tighter than `minPower` takes `expr` as its left operand, and
+    // its right operand extends over operators binding tighter than itself, so equal powers associate left.
     Expr::Ptr expr = parseUnary();
-    while (match(TK_MUL) || match(TK_DIV) || match(TK_MOD)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseUnary();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+    while (true) {
+        const TokenType type = tokens.type(cursor);
+        const uint8_t power = noIn && type == TK_IN ? 0 : BINARY_POWER[type];
+        if (power <= minPower) {
+            return expr;
+        }
+        Token opTok = advance();
+        Expr::Ptr right = parseBinary(power, noIn);
+        expr = this->make<BinaryExpr>(std::move(expr), std::pmr::string(opTok.value, this->allocator()), std::move(right));
     }
-    return expr;
 }
 
-Expr::Ptr Parser::parseAdditive() {
-    Expr::Ptr expr = parseMultiplicative();
-    while (match(TK_ADD) || match(TK_SUB)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseMultiplicative();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+Expr::Ptr Parser::parseConditional(bool noIn) {
+    Expr::Ptr expr = parseBinary(0, noIn);
+    if (match(TK_CONDITIONAL)) {
+        expr = ConditionalExpr::parse(*this, std::move(expr));
     }
     return expr;
 }
 
-Expr::Ptr Parser::parseShift() {
-    Expr::Ptr expr = parseAdditive();
-    while (match(TK_SAR) || match(TK_SHL) || match(TK_SHR)) {
+Expr::Ptr Parser::parseAssignment(bool noIn) {
+    if ((flags & PARSE_EXPLICIT_STACK) != 0) {
+        return parseExpressionIteratively(ExprStep::ASSIGNMENT, noIn);
+    }
+    Expr::Ptr expr = parseConditional(noIn);
+    if (matchAny(ASSIGNMENT_OPERATORS)) {
         Token opTok = previous();
-        Expr::Ptr right = parseAdditive();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+        Expr::Ptr right = parseAssignment(noIn);
+        expr = this->make<AssignementExpr>(std::move(expr), std::pmr::string(opTok.value, this->allocator()), std::move(right));
     }
     return expr;
 }
 
-Expr::Ptr Parser::parseRelational() {
-    Expr::Ptr expr = parseShift();
-    while (match(TK_LT) || match(TK_GT) || match(TK_LTE) || match(TK_GTE) || match(TK_IN) || match(TK_INSTANCEOF)) {
+Expr::Ptr Parser::parseComma(bool noIn) {
+    Expr::Ptr expr = parseAssignment(noIn);
+    while (match(TK_COMMA)) {
         Token opTok = previous();
-        Expr::Ptr right = parseShift();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+        Expr::Ptr right = parseAssignment(noIn);
+        expr = this->make<BinaryExpr>(std::move(expr), std::pmr::string(opTok.value, this->allocator()), std::move(right));
     }
     return expr;
 }
 
-Expr::Ptr Parser::parseEquality() {
-    Expr::Ptr expr = parseRelational();
-    while (match(TK_EQ) || match(TK_NE) || match(TK_EQ_STRICT) || match(TK_NE_STRICT)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseRelational();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+Expr::Ptr Parser::parseExpression(bool noIn) {
+    if ((flags & PARSE_EXPLICIT_STACK) != 0) {
+        return parseExpressionIteratively(ExprStep::COMMA, noIn);
     }
-    return expr;
+    return parseComma(noIn);
 }
 
-Expr::Ptr Parser::parseBitwiseAnd() {
-    Expr::Ptr expr = parseEquality();
-    while (match(TK_BIT_AND)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseEquality();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+void Parser::enter() {
+    if (++depth > depthLimit) {
+        depth--;
+        fail("Parser", "Nesting exceeds the depth limit of " + std::to_string(depthLimit));
     }
-    return expr;
 }
 
-Expr::Ptr Parser::parseBitwiseXor() {
-    Expr::Ptr expr = parseBitwiseAnd();
-    while (match(TK_BIT_XOR)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseBitwiseAnd();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+void Parser::pushExpr(ExprStep step, bool noIn, uint8_t power) {
+    if (step == ExprStep::UNARY) {
+        enter();
     }
-    return expr;
+    exprFrames.push_back({step, noIn, power, {}, items.size(), nullptr, nullptr});
 }
 
-Expr::Ptr Parser::parseBitwiseOr() {
-    Expr::Ptr expr = parseBitwiseXor();
-    while (match(TK_BIT_OR)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseBitwiseXor();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+void Parser::pushStmt() {
+    // Pushed before the check, so that the statement that is too deep is the one that fails.
+    stmtFrames.push_back({StmtStep::STATEMENT, cursor, statements.size(), nullptr, nullptr});
+    if (++depth > depthLimit) {
+        fail("Parser", "Nesting exceeds the depth limit of " + std::to_string(depthLimit));
     }
-    return expr;
 }
 
-Expr::Ptr Parser::parseLogicalAnd() {
-    Expr::Ptr expr = parseBitwiseOr();
-    while (match(TK_LOGICAL_AND)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseBitwiseOr();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+namespace {
+/** Puts the depth and the explicit stacks of a parser back as they were when a run is cut short by a ParseError. */
+template <typename... Stacks>
+class Unwind {
+public:
+    explicit Unwind(size_t& depth, Stacks&... stacks)
+        : depth(depth), savedDepth(depth), stacks(stacks...), savedSizes{stacks.size()...} {
     }
-    return expr;
-}
 
-Expr::Ptr Parser::parseLogicalOr() {
-    Expr::Ptr expr = parseLogicalAnd();
-    while (match(TK_LOGICAL_OR)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseLogicalAnd();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+    ~Unwind() {
+        depth = savedDepth;
+        std::apply([this](auto&... stack) {
+            size_t i = 0;
+            (stack.erase(stack.begin() + static_cast<ptrdiff_t>(savedSizes[i++]), stack.end()), ...);
+        }, stacks);
     }
-    return expr;
+
+private:
+    size_t& depth;
+    size_t savedDepth;
+    std::tuple<Stacks&...> stacks;
+    std::array<size_t, sizeof...(Stacks)> savedSizes;
+};
+
+/** Whether a frame at `step` stands for a parseUnary() call, the level counted against the depth limit. */
+constexpr bool isUnaryStep(auto step) {
+    return step == decltype(step)::UNARY || step == decltype(step)::UNARY_OPERAND ||
+           step == decltype(step)::UNARY_POSTFIX;
+}
 }
 
-Expr::Ptr Parser::parseConditional() {
-    Expr::Ptr expr = parseLogicalOr();
-    if (match(TK_CONDITIONAL)) {
-        expr = ConditionalExpr::parse(*this, std::move(expr));
+Expr::Ptr Parser::parseExpressionIteratively(ExprStep start, bool noIn) {
+    // Every frame resumes where the recursive function it stands for would after a call returns, so both
+    // parsers consume the same tokens, build the same nodes and fail with the same errors. A frame that is
+    // done leaves its node in `result` for the frame below.
+    const size_t base = exprFrames.size();
+    Unwind unwind(depth, exprFrames, items, keys);
+    Expr::Ptr result;
+    pushExpr(start, noIn);
+    while (true) {
+        // Frames are only referenced until the next push: the push, or a nested run, may reallocate them.
+        ExprFrame& frame = exprFrames.back();
+        switch (frame.step) {
+            case ExprStep::COMMA:
+                frame.step = ExprStep::COMMA_LEFT;
+                pushExpr(ExprStep::ASSIGNMENT, frame.noIn);
+                continue;
+            case ExprStep::COMMA_RIGHT:
+                result = make<BinaryExpr>(std::move(frame.expr), std::pmr::string(frame.op, allocator()), std::move(result));
+                [[fallthrough]];
+            case ExprStep::COMMA_LEFT:
+                if (match(TK_COMMA)) {
+                    frame.expr = std::move(result);
+                    frame.op = previous().value;
+                    frame.step = ExprStep::COMMA_RIGHT;
+                    pushExpr(ExprStep::ASSIGNMENT, frame.noIn);
+                    continue;
+                }
+                break;
+
+            case ExprStep::ASSIGNMENT:
+                frame.step = ExprStep::ASSIGNMENT_LEFT;
+                pushExpr(ExprStep::CONDITIONAL, frame.noIn);
+                continue;
+            case ExprStep::ASSIGNMENT_LEFT:
+                if (matchAny(ASSIGNMENT_OPERATORS)) {
+                    frame.expr = std::move(result);
+                    frame.op = previous().value;
+                    frame.step = ExprStep::ASSIGNMENT_RIGHT;
+                    pushExpr(ExprStep::ASSIGNMENT, frame.noIn);
+                    continue;
+                }
+                break;
+            case ExprStep::ASSIGNMENT_RIGHT:
+                result = make<AssignementExpr>(std::move(frame.expr), std::pmr::string(frame.op, allocator()), std::move(result));
+                break;
+
+            case ExprStep::CONDITIONAL:
+                frame.step = ExprStep::CONDITIONAL_TEST;
+                pushExpr(ExprStep::BINARY, frame.noIn, 0);
+                continue;
+            case ExprStep::CONDITIONAL_TEST:
+                if (match(TK_CONDITIONAL)) {
+                    frame.expr = std::move(result);
+                    frame.step = ExprStep::CONDITIONAL_TRUE;
+                    pushExpr(ExprStep::COMMA, false);
+                    continue;
+                }
+                break;
+            case ExprStep::CONDITIONAL_TRUE:
+                frame.middle = std::move(result);
+                consume(TK_COLON, "ConditionalExpr", "Expected ':' in conditional expression.");
+                frame.step = ExprStep::CONDITIONAL_FALSE;
+                pushExpr(ExprStep::COMMA, false);
+                continue;
+            case ExprStep::CONDITIONAL_FALSE:
+                result = make<ConditionalExpr>(std::move(frame.expr), std::move(frame.middle), std::move(result));
+                break;
+
+            case ExprStep::BINARY:
+                frame.step = ExprStep::BINARY_LEFT;
+                pushExpr(ExprStep::UNARY, false);
+                continue;
+            case ExprStep::BINARY_RIGHT:
+                result = make<BinaryExpr>(std::move(frame.expr), std::pmr::string(frame.op, allocator()), std::move(result));
+                [[fallthrough]];
+            case ExprStep::BINARY_LEFT: {
+                const TokenType type = tokens.type(cursor);
+                const uint8_t power = frame.noIn && type == TK_IN ? 0 : BINARY_POWER[type];
+                if (power <= frame.power) {
+                    break;
+                }
+                frame.expr = std::move(result);
+                frame.op = advance().value;
+                frame.step = ExprStep::BINARY_RIGHT;
+                pushExpr(ExprStep::BINARY, frame.noIn, power);
+                continue;
+            }
+
+            case ExprStep::UNARY:
+                if (UNARY_OPERATORS.contains(tokens.type(cursor))) {
+                    frame.op = advance().value;
+                    frame.step = ExprStep::UNARY_OPERAND;
+                    pushExpr(ExprStep::UNARY, false);
+                } else {
+                    frame.step = ExprStep::UNARY_POSTFIX;
+                    pushExpr(ExprStep::LEFT_HAND_SIDE, false);
+                }
+                continue;
+            case ExprStep::UNARY_OPERAND:
+                result = make<UnaryExpr>(std::pmr::string(frame.op, allocator()), std::move(result));
+                break;
+            case ExprStep::UNARY_POSTFIX:
+                if (!matchSemicolon() && matchAny(UPDATE_OPERATORS)) {
+                    result = make<PostfixExpr>(std::pmr::string(previous().value, allocator()), std::move(result));
+                }
+                break;
+
+            case ExprStep::LEFT_HAND_SIDE:
+                frame.step = ExprStep::LEFT_HAND_SIDE_OBJECT;
+                pushExpr(ExprStep::NEW_OR_MEMBER, false);
+                continue;
+            case ExprStep::LEFT_HAND_SIDE_PROPERTY:
+                consume(TK_RBRACK, "MemberExpr", "Expected ']' after property expression.");
+                result = make<MemberExpr>(std::move(frame.expr), std::move(result), false);
+                frame.step = ExprStep::LEFT_HAND_SIDE_OBJECT;
+                continue;
+            case ExprStep::LEFT_HAND_SIDE_ARGUMENT:
+                items.push_back(std::move(result));
+                if (match(TK_COMMA)) {
+                    pushExpr(ExprStep::ASSIGNMENT, false);
+                    continue;
+                }
+                consume(TK_RPAREN, "CallExpr", "Expected ')' after arguments.");
+                result = make<CallExpr>(std::move(frame.expr), takeItems(frame.mark));
+                frame.step = ExprStep::LEFT_HAND_SIDE_OBJECT;
+                continue;
+            case ExprStep::LEFT_HAND_SIDE_OBJECT:
+                if (matchAny(MEMBER_ACCESS)) {
+                    if (previous().type == TK_PERIOD) {
+                        Expr::Ptr property = Identifier::parse(*this);
+                        result = make<MemberExpr>(std::move(result), std::move(property), true);
+                        continue;
+                    }
+                    frame.expr = std::move(result);
+                    frame.step = ExprStep::LEFT_HAND_SIDE_PROPERTY;
+                    pushExpr(ExprStep::COMMA, false);
+                    continue;
+                }
+                if (match(TK_LPAREN)) {
+                    frame.expr = std::move(result);
+                    if (!check(TK_RPAREN)) {
+                        frame.step = ExprStep::LEFT_HAND_SIDE_ARGUMENT;
+                        pushExpr(ExprStep::ASSIGNMENT, false);
+                        continue;
+                    }
+                    consume(TK_RPAREN, "CallExpr", "Expected ')' after arguments.");
+                    result = make<CallExpr>(std::move(frame.expr), takeItems(frame.mark));
+                    continue;
+                }
+                break;
+
+            case ExprStep::NEW_OR_MEMBER:
+                if (match(TK_NEW)) {
+                    frame.step = ExprStep::NEW_CALLEE;
+                    pushExpr(ExprStep::NEW_OR_MEMBER, false);
+                } else {
+                    frame.step = ExprStep::MEMBER_OBJECT;
+                    pushExpr(ExprStep::PRIMARY, false);
+                }
+                continue;
+            case ExprStep::NEW_CALLEE:
+                frame.expr = std::move(result);
+                if (match(TK_LPAREN)) {
+                    if (!check(TK_RPAREN)) {
+                        frame.step = ExprStep::NEW_ARGUMENT;
+                        pushExpr(ExprStep::COMMA, false);
+                        continue;
+                    }
+                    consume(TK_RPAREN, "NewExpr", "Expected ')' after arguments.");
+                }
+                result = make<NewExpr>(std::move(frame.expr), takeItems(frame.mark));
+                frame.step = ExprStep::MEMBER_OBJECT;
+                continue;
+            case ExprStep::NEW_ARGUMENT:
+                items.push_back(std::move(result));
+                if (match(TK_COMMA)) {
+                    pushExpr(ExprStep::COMMA, false);
+                    continue;
+                }
+                consume(TK_RPAREN, "NewExpr", "Expected ')' after arguments.");
+                result = make<NewExpr>(std::move(frame.expr), takeItems(frame.mark));
+                frame.step = ExprStep::MEMBER_OBJECT;
+                continue;
+            case ExprStep::MEMBER_PROPERTY:
+                consume(TK_RBRACK, "MemberExpr", "Expected ']' after property expression.");
+                result = make<MemberExpr>(std::move(frame.expr), std::move(result), false);
+                frame.step = ExprStep::MEMBER_OBJECT;
+                continue;
+            case ExprStep::MEMBER_OBJECT:
+                if (matchAny(MEMBER_ACCESS)) {
+                    if (previous().type == TK_PERIOD) {
+                        Expr::Ptr property = Identifier::parse(*this);
+                        result = make<MemberExpr>(std::move(result), std::move(property), true);
+                        continue;
+                    }
+                    frame.expr = std::move(result);
+                    frame.step = ExprStep::MEMBER_PROPERTY;
+                    pushExpr(ExprStep::COMMA, false);
+                    continue;
+                }
+                break;
+
+            case ExprStep::PRIMARY:
+                switch (tokens.type(cursor)) {
+                    case TK_LBRACK:
+                        advance();
+                        if (check(TK_RBRACK)) {
+                            advance();
+                            result = make<Array>(takeItems(frame.mark));
+                            break;
+                        }
+                        frame.step = ExprStep::ARRAY_NEXT;
+                        continue;
+                    case TK_LBRACE:
+                        advance();
+                        if (check(TK_RBRACE)) {
+                            advance();
+                            result = make<Object>(takeProperties(frame.mark));
+                            break;
+                        }
+                        frame.step = ExprStep::OBJECT_KEY;
+                        continue;
+                    case TK_LPAREN:
+                        advance();
+                        frame.step = ExprStep::GROUPED;
+                        pushExpr(ExprStep::COMMA, false);
+                        continue;
+                    default:
+                        // Leaves, and function expressions whose bodies recurse through parseStatement().
+                        result = parsePrimary();
+                        break;
+                }
+                break;
+            case ExprStep::ARRAY_NEXT:
+                if (!check(TK_COMMA)) {
+                    frame.step = ExprStep::ARRAY_ELEMENT;
+                    pushExpr(ExprStep::ASSIGNMENT, false);
+                    continue;
+                }
+                result = make<Undefined>(); // a hole
+                [[fallthrough]];
+            case ExprStep::ARRAY_ELEMENT:
+                items.push_back(std::move(result));
+                if (match(TK_COMMA) && !check(TK_RBRACK)) {
+                    frame.step = ExprStep::ARRAY_NEXT;
+                    continue;
+                }
+                consume(TK_RBRACK, "Array", "Expected ']' at end of array literal.");
+                result = make<Array>(takeItems(frame.mark));
+                break;
+            case ExprStep::OBJECT_KEY:
+                keys.emplace_back(consume({TK_STRING, TK_IDENTIFIER}, "Object", "Expected string or identifier as object key.").str(), allocator());
+                consume(TK_COLON, "Object", "Expected ':' after object key.");
+                frame.step = ExprStep::OBJECT_VALUE;
+                pushExpr(ExprStep::ASSIGNMENT, false);
+                continue;
+            case ExprStep::OBJECT_VALUE:
+                items.push_back(std::move(result));
+                if (match(TK_COMMA) && !check(TK_RBRACE)) {
+                    frame.step = ExprStep::OBJECT_KEY;
+                    continue;
+                }
+                consume(TK_RBRACE, "Object", "Expected '}' at end of object literal.");
+                result = make<Object>(takeProperties(frame.mark));
+                break;
+            case ExprStep::GROUPED:
+                consume(TK_RPAREN, "Grouped", "Expected ')' at end of grouped expression.");
+                result = make<Grouped>(std::move(result));
+                break;
+        }
+        if (isUnaryStep(exprFrames.back().step)) {
+            depth--;
+        }
+        exprFrames.pop_back();
+        if (exprFrames.size() == base) {
+            return result;
+        }
     }
-    return expr;
 }
 
-Expr::Ptr Parser::parseAssignment() {
-    Expr::Ptr expr = parseConditional();
-    if (match(TK_ASSIGN) || match(TK_ASSIGN_ADD) || match(TK_ASSIGN_SUB) || match(TK_ASSIGN_MUL) ||
-        match(TK_ASSIGN_DIV) || match(TK_ASSIGN_MOD) || match(TK_ASSIGN_BIT_AND) || match(TK_ASSIGN_BIT_OR) ||
-        match(TK_ASSIGN_BIT_XOR) || match(TK_ASSIGN_SAR) || match(TK_ASSIGN_SHL) || match(TK_ASSIGN_SHR)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseAssignment();
-        expr = std::make_unique<AssignementExpr>(std::move(expr), opTok.value, std::move(right));
+Stmt::Ptr Parser::parseStatementIteratively() {
+    const size_t base = stmtFrames.size();
+    Unwind unwind(depth, stmtFrames, statements);
+    Stmt::Ptr result;
+    pushStmt();
+    while (true) {
+        try {
+            StmtFrame& frame = stmtFrames.back();
+            switch (frame.step) {
+                case StmtStep::STATEMENT:
+                    if (match(TK_LBRACE)) {
+                        frame.step = StmtStep::BLOCK;
+                        continue;
+                    }
+                    if (match(TK_IF)) {
+                        consume(TK_LPAREN, "IfStmt", "Expected '(' after 'if'.");
+                        Expr::Ptr test = parseExpression();
+                        consume(TK_RPAREN, "IfStmt", "Expected ')' after condition.");
+                        // A function expression in the test may have run statements and moved the frames.
+                        stmtFrames.back().test = std::move(test);
+                        stmtFrames.back().step = StmtStep::IF_CONSEQUENT;
+                        pushStmt();
+                        continue;
+                    }
+                    result = dispatchStatement();
+                    break;
+                case StmtStep::BLOCK_ITEM:
+                    statements.push_back(std::move(result));
+                    [[fallthrough]];
+                case StmtStep::BLOCK:
+                    if (!check(TK_RBRACE) && !isAtEnd()) {
+                        frame.step = StmtStep::BLOCK_ITEM;
+                        pushStmt();
+                        continue;
+                    }
+                    consume(TK_RBRACE, "BlockStmt", "Expected '}' at end of block.");
+                    match(TK_SEMICOLON); // optional semicolon after block
+                    result = make<BlockStmt>(takeStatements(frame.mark));
+                    break;
+                case StmtStep::IF_CONSEQUENT:
+                    if (match(TK_ELSE)) {
+                        frame.consequent = std::move(result);
+                        frame.step = StmtStep::IF_ALTERNATE;
+                        pushStmt();
+                        continue;
+                    }
+                    result = make<IfStmt>(std::move(frame.test), std::move(result), nullptr);
+                    break;
+                case StmtStep::IF_ALTERNATE:
+                    result = make<IfStmt>(std::move(frame.test), std::move(frame.consequent), std::move(result));
+                    break;
+            }
+        } catch (const ParseError& error) {
+            if ((flags & PARSE_RECOVER) == 0) {
+                throw;
+            }
+            // Nested runs have unwound, so the innermost open statement is the one that failed.
+            const StmtFrame& failed = stmtFrames.back();
+            statements.erase(statements.begin() + static_cast<ptrdiff_t>(failed.mark), statements.end());
+            result = recover(error, failed.start);
+        }
+        depth--;
+        stmtFrames.pop_back();
+        if (stmtFrames.size() == base) {
+            return result;
+        }
     }
-    return expr;
 }
 
-Expr::Ptr Parser::parseComma() {
-    Expr::Ptr expr = parseAssignment();
-    while (match(TK_COMMA)) {
-        Token opTok = previous();
-        Expr::Ptr right = parseAssignment();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), opTok.value, std::move(right));
+std::pmr::vector<Expr::Ptr> Parser::takeItems(size_t mark) {
+    const auto first = items.begin() + static_cast<ptrdiff_t>(mark);
+    std::pmr::vector<Expr::Ptr> taken(std::make_move_iterator(first), std::make_move_iterator(items.end()), allocator());
+    items.erase(first, items.end());
+    return taken;
+}
+
+std::pmr::vector<Property> Parser::takeProperties(size_t mark) {
+    // Keys and values are pushed in pairs, so the last keys are this object's.
+    const auto first = items.begin() + static_cast<ptrdiff_t>(mark);
+    const auto firstKey = keys.end() - (items.end() - first);
+    std::pmr::vector<Property> taken(allocator());
+    taken.reserve(items.size() - mark);
+    auto key = firstKey;
+    for (auto value = first; value != items.end(); ++value, ++key) {
+        taken.emplace_back(std::move(*key), std::move(*value));
     }
-    return expr;
+    items.erase(first, items.end());
+    keys.erase(firstKey, keys.end());
+    return taken;
 }
 
-Expr::Ptr Parser::parseExpression() {
-    return parseComma();
+std::pmr::vector<Stmt::Ptr> Parser::takeStatements(size_t mark) {
+    const auto first = statements.begin() + static_cast<ptrdiff_t>(mark);
+    std::pmr::vector<Stmt::Ptr> taken(std::make_move_iterator(first), std::make_move_iterator(statements.end()), allocator());
+    statements.erase(first, statements.end());
+    return taken;
 }
 
-bool Parser::match(TokenType type, const std::string& lexme) {
+bool Parser::match(TokenType type, std::string_view lexme) {
     if (check(type, lexme)) {
         advance();
         return true;
@@ -294,52 +941,43 @@ bool Parser::match(TokenType type, const std::string& lexme) {
     return false;
 }
 
-Token Parser::consume(std::function<bool(const Token&)> predicate, const std::string& ParserName, const std::string& errorMessage) {
-    if (predicate(peek())) {
-        return advance();
-    }
-    throw ParseError("[" + ParserName + "] " + errorMessage + " at line " + std::to_string(peek().line) + " col " + std::to_string(peek().column) + ". Found '" + peek().value + "'");
+void Parser::fail(std::string_view parserName, std::string_view errorMessage, std::string_view end) const {
+    std::string message = "[";
+    message.append(parserName).append("] ").append(errorMessage).append(" at ").append(position(peek()));
+    message.append(". Found '").append(peek().value).append("'").append(end);
+    throw ParseError(message);
 }
 
-Token Parser::consume(TokenType type, const std::string& ParserName, const std::string& errorMessage) {
-    if (check(type)) {
-        return advance();
+Token Parser::previous() const {
+    if (cursor == 0) {
+        return Token(TK_EOS);
     }
-    throw ParseError("[" + ParserName + "] " + errorMessage + " at line " + std::to_string(peek().line) + " col " + std::to_string(peek().column) + ". Found '" + peek().value + "'");
+    return tokens.at(cursor - 1);
 }
 
-const Token& Parser::previous() const {
-    return tokens[cursor - 1];
-}
-
-const Token& Parser::peek() const {
-    if (cursor >= tokens.size() - 1) {
-        return tokens.back();
-    }
-    return tokens[cursor];
+Token Parser::peek() const {
+    return tokens.at(cursor);
 }
 
-const Token& Parser::advance() {
+Token Parser::advance() {
     if (!isAtEnd()) {
         cursor++;
     }
     return previous();
 }
 
-const Token& Parser::reverse() {
+Token Parser::reverse() {
     if (cursor > 0) {
+        if (!tokens.retains(cursor - 1)) {
+            throw ParseError("Cannot backtrack past the token window at " + position(peek()) + ".");
+        }
         cursor--;
     }
     return peek();
 }
 
-bool Parser::check(TokenType type, const std::string& lexme) {
-    if (isAtEnd()) {
-        return false;
-    }
-    skipEols();
-    const Token& token = peek();
-    return token.type == type && (lexme.empty() || token.value == lexme);
+bool Parser::check(TokenType type, std::string_view lexme) const {
+    return check(type) && (lexme.empty() || peek().value == lexme);
 }
 
 bool Parser::matchSemicolon(bool needAdvance) {
@@ -356,25 +994,21 @@ bool Parser::matchSemicolon(bool needAdvance) {
     }
 
     // 1
-    if (previous().type == TK_EOL || peek().type == TK_RBRACE) {
+    if (tokens.newlineBefore(cursor) || tokens.type(cursor) == TK_RBRACE) {
         return true;
     }
     return false;
 }
 
-void Parser::expectSemicolon(const std::string& ParserName, const std::string& errorMessage) {
+void Parser::expectSemicolon(std::string_view parserName, std::string_view errorMessage) {
     if (!matchSemicolon(true)) {
-        throw ParseError("[" + ParserName + "] " + errorMessage + " at line " + std::to_string(peek().line) + " col " + std::to_string(peek().column) + ". Found '" + peek().value + "'.");
+        fail(parserName, errorMessage, ".");
     }
 }
 
-bool Parser::isAtEnd() const {
-    return cursor >= tokens.size() || peek().type == TK_EOS;
+std::string Parser::position(const Token& token) const {
+    SourceLocation location = tokens.location(token);
+    return "line " + std::to_string(location.line) + " col " + std::to_string(location.column);
 }
 
-void Parser::skipEols() {
-    while (!isAtEnd() && peek().type == TK_EOL) {
-        advance();
-    }
-}
 }
\ No newline at end of file
@@ -1,169 +1,757 @@
-#include <iostream>
+#include <algorithm>
+#include <charconv>
 #include <cstring>
+#include <iostream>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "../../include/Tokenizer/Lexer.hpp"
+#include "../../include/Tokenizer/Scanner.hpp"
+#include "../../include/Tokenizer/Unicode.hpp"
+#include "../../include/Utils/ThreadPool.hpp"
 
-Lexer::Lexer::Lexer(std::string& content)
+namespace {
+/** Read-only private mapping of a whole file, unmapped when the last lexer using it goes away. */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot open '" + path + "'");
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Cannot stat '" + path + "'");
+        }
+        this->size = static_cast<size_t>(info.st_size);
+        if (this->size > 0) {
+            void* address = ::mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Cannot map '" + path + "'");
+            }
+            ::madvise(address, this->size, MADV_SEQUENTIAL);
+            this->data = static_cast<const char*>(address);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (this->data != nullptr) {
+            ::munmap(const_cast<char*>(this->data), this->size);
+        }
+    }
+
+    std::string_view view() const {
+        return {this->data, this->size};
+    }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+bool isAsciiAlpha(char ch) {
+    return static_cast<unsigned char>((ch | 0x20) - 'a') < 26;
+}
+
+bool isHexDigit(char ch) {
+    return Lexer::charClass(ch) == Lexer::CC_DIGIT || static_cast<unsigned char>((ch | 0x20) - 'a') < 6;
+}
+
+int hexValue(char ch) {
+    return Lexer::charClass(ch) == Lexer::CC_DIGIT ? ch - '0' : (ch | 0x20) - 'a' + 10;
+}
+
+bool isPlainAscii(std::string_view text) {
+    unsigned char bits = 0;
+    for (const char ch : text) {
+        bits |= static_cast<unsigned char>(ch);
+        bits |= (ch == '\\') << 7;
+    }
+    return bits < 0x80;
+}
+
+/** First line terminator in text[from, to): '\n', '\r', U+2028 or U+2029 (ES5 7.3), or `to`. */
+size_t findLineTerminator(std::string_view text, size_t from, size_t to) {
+    // The others are rare; look for them only before the first '\n'.
+    size_t end = Lexer::Scan::findNewline(text.substr(0, to), from);
+    if (const void* cr = std::memchr(text.data() + from, '\r', end - from)) {
+        end = static_cast<const char*>(cr) - text.data();
+    }
+    // LS and PS are E2 80 A8 and E2 80 A9.
+    for (size_t i = from; i < end;) {
+        const void* lead = std::memchr(text.data() + i, '\xE2', end - i);
+        if (lead == nullptr) {
+            break;
+        }
+        i = static_cast<const char*>(lead) - text.data();
+        if (i + 2 < to && text[i + 1] == '\x80' && (text[i + 2] == '\xA8' || text[i + 2] == '\xA9')) {
+            return i;
+        }
+        i++;
+    }
+    return end;
+}
+}
+
+Lexer::Lexer::Lexer(std::string_view content, std::shared_ptr<const void> source)
     : content(content),
       cursor(0),
-      line(0),
-      start_of_line(0) {
+      source(std::move(source)) {
+}
+
+Lexer::Lexer::Lexer(std::string& content)
+    : Lexer(copyOf(content)) {
 }
 
 Lexer::Lexer::Lexer(const char* content)
-    : content(content),
-      cursor(0),
-      line(0),
-      start_of_line(0) {
+    : Lexer(copyOf(content)) {
+}
+
+Lexer::Lexer::Lexer(std::string_view content)
+    : Lexer(content, nullptr) {
+}
+
+Lexer::Lexer Lexer::Lexer::copyOf(std::string_view content) {
+    auto copy = std::make_shared<const std::string>(content);
+    return Lexer(*copy, copy);
 }
 
-std::vector<Lexer::Token> Lexer::Lexer::tokenize() {
-    std::vector<Token> tokens;
+Lexer::Lexer Lexer::Lexer::fromFile(const std::string& path) {
+    auto mapping = std::make_shared<const MappedFile>(path);
+    return Lexer(mapping->view(), mapping);
+}
+
+Lexer::TokenBuffer Lexer::Lexer::tokenize() {
+    TokenBuffer tokens(this->content);
+    tokens.reserve(TokenBuffer::estimateTokens(this->content.size() - std::min(this->cursor, this->content.size())));
     while (!this->content.empty()) {
         Token token = this->nextToken();
         if (token.type == TK_EOS) {
             break;
         }
-        tokens.push_back(token);
+        tokens.push(token);
     }
     return tokens;
 }
 
+std::string_view Lexer::Lexer::view(size_t start, size_t length) const {
+    return this->content.substr(start, length);
+}
+
 void Lexer::Lexer::leftTrim() {
-    while (this->cursor < this->content.size() &&
-           Token::isSkippable(this->content[this->cursor])) {
-        this->cursor++;
+    // Most gaps are a single space, so only hand longer runs to the block scanner.
+    if (this->cursor < this->content.size() && Token::isSkippable(this->content[this->cursor])) {
+        this->cursor = Scan::findNonSpace(this->content, this->cursor + 1);
     }
 }
 
-Lexer::Token Lexer::Lexer::nextToken() {
-    this->leftTrim();
-    if (this->cursor >= this->content.size()) {
-        return Token(TK_EOS);
+Lexer::TokenBuffer Lexer::Lexer::tokenizeParallel(size_t threads) {
+    if (threads == 0) {
+        threads = Utils::ThreadPool::defaultThreads();
+    }
+    const size_t bytes = this->content.size() - std::min(this->cursor, this->content.size());
+    const size_t chunks = std::min(threads * 4, bytes / PARALLEL_MIN_CHUNK);
+    if (threads < 2 || chunks < 2) {
+        return this->tokenize();
     }
-    char ch = this->content[this->cursor];
 
-    // Single line comment
-    if (this->cursor + 1 < this->content.size() && ch == '/' && this->content[this->cursor + 1] == '/') {
-        this->cursor += 1;
-        while (this->cursor < this->content.size() && this->content[this->cursor] != '\n') {
-            this->cursor++;
+    const std::vector<size_t> bounds = this->chunkBounds(chunks);
+    std::vector<Chunk> lexed;
+    {
+        Utils::ThreadPool pool(threads);
+        std::vector<std::future<Chunk>> pending;
+        for (size_t i = 0; i + 1 < bounds.size(); i++) {
+            pending.push_back(pool.submit([this, from = bounds[i], to = bounds[i + 1]] {
+                return this->lexChunk(from, to);
+            }));
+        }
+        for (std::future<Chunk>& chunk : pending) {
+            lexed.push_back(chunk.get());
         }
-        return this->nextToken();
     }
+    return this->stitch(lexed, bounds);
+}
 
-    // Multi-line comment
-    if (this->cursor + 1 < this->content.size() && ch == '/' && this->content[this->cursor + 1] == '*') {
-        this->cursor += 2;
-        while (this->cursor < this->content.size() && (this->content[this->cursor] != '*' || this->content[this->cursor + 1] != '/')) {
-            this->cursor++;
+std::vector<size_t> Lexer::Lexer::chunkBounds(size_t chunks) const {
+    // Split right after a newline near each even cut. A cut can still land inside a string, comment
+    // or regex literal; that is detected while stitching.
+    const size_t begin = std::min(this->cursor, this->content.size());
+    const size_t bytes = this->content.size() - begin;
+    std::vector<size_t> bounds = {begin};
+    for (size_t i = 1; i < chunks; i++) {
+        size_t cut = Scan::findNewline(this->content, begin + bytes / chunks * i) + 1;
+        if (cut < this->content.size() && cut > bounds.back()) {
+            bounds.push_back(cut);
         }
-        this->cursor += 2;
-        return this->nextToken();
     }
+    bounds.push_back(this->content.size());
+    return bounds;
+}
 
-    // Semicolon
-    if (ch == ';') {
-        this->cursor++;
-        return {std::string(1, ch), TK_SEMICOLON, this->line, (this->cursor - this->start_of_line)};
+Lexer::TokenBuffer Lexer::Lexer::stitch(std::vector<Chunk>& lexed, const std::vector<size_t>& bounds) {
+    // Decoded strings are referenced by the tokens, keep them alive with this lexer.
+    auto keepStrings = [this](Chunk& chunk) {
+        for (auto& string : chunk.strings) {
+            this->strings.push_back(std::move(string));
+        }
+    };
+    for (Chunk& chunk : lexed) {
+        keepStrings(chunk);
     }
 
-    // End of line
-    if (ch == '\n' ||
-        (ch == '\r' && this->cursor + 1 < this->content.size() && this->content[this->cursor + 1] == '\n')) {
-        this->cursor += (ch == '\r' ? 2 : 1);
-        this->line++;
-        this->start_of_line = this->cursor;
-        while (this->cursor < this->content.size() && (
-                   this->content[this->cursor] == '\n' ||
-                   (this->content[this->cursor] == '\r' && this->cursor + 1 < this->content.size() && this->content[this->cursor + 1] == '\n'))) {
-            this->cursor += (this->content[this->cursor] == '\r' ? 2 : 1);
-            this->line++;
-            this->start_of_line = this->cursor;
+    // The lexer has no state besides its cursor, so a chunk that also produced the token the previous
+    // chunk ran into is correct from there on. Otherwise re-lex it from that token's span start,
+    // which for a string is its opening quote.
+    // Offsets alone are ambiguous: a string value starts at the same offset as the code a wrong cut
+    // sees right after the quote, so the type and length have to match too.
+    TokenBuffer tokens(this->content);
+    size_t total = 0;
+    for (const Chunk& chunk : lexed) {
+        total += chunk.tokens.size();
+    }
+    tokens.reserve(total);
+    tokens.append(lexed[0].tokens, 0);
+    Token next = lexed[0].next;
+    for (size_t i = 1; i < lexed.size() && next.type != TK_EOS; i++) {
+        if (next.offset >= bounds[i + 1]) {
+            continue; // the previous chunk's last token covers this whole chunk
+        }
+        Chunk* chunk = &lexed[i];
+        size_t index = chunk->tokens.find(next.offset);
+        if (index == chunk->tokens.size() || chunk->tokens.type(index) != next.type ||
+            chunk->tokens.length(index) != next.value.size()) {
+            *chunk = this->lexChunk(next.offset - (next.type == TK_STRING ? 1 : 0), bounds[i + 1]);
+            keepStrings(*chunk);
+            index = 0;
         }
-        return {std::string(1, '\n'), TK_EOL, this->line - 1, 0};
+        // `next` carries the newline-before flag as seen from the previous chunk.
+        tokens.push(next);
+        tokens.append(chunk->tokens, index + 1);
+        next = chunk->next;
     }
+    this->cursor = this->content.size();
+    return tokens;
+}
 
-    // String literal
-    if (ch == '\'' || ch == '"') {
-        std::string value;
-        size_t backslash = 0;
-        this->cursor++;
-        while (this->cursor < this->content.size() &&
-               (this->content[this->cursor] != ch || backslash % 2 != 0)) {
-            if (this->content[this->cursor] == (ch == '\'' ? '"' : '\'')) {
-                value += '\\';
+std::vector<Lexer::TokenBuffer> Lexer::Lexer::tokenizeEach(std::vector<Lexer>& lexers, size_t threads) {
+    if (threads == 0) {
+        threads = Utils::ThreadPool::defaultThreads();
+    }
+    std::vector<TokenBuffer> results(lexers.size());
+    if (threads < 2) {
+        for (size_t i = 0; i < lexers.size(); i++) {
+            results[i] = lexers[i].tokenize();
+        }
+        return results;
+    }
+
+    // Aim for a few tasks per worker: sources well above the target size are split into chunks and
+    // stitched like tokenizeParallel(), the rest are packed into groups of about the target size.
+    size_t total = 0;
+    for (const Lexer& lexer : lexers) {
+        total += lexer.content.size();
+    }
+    const size_t target = std::max(PARALLEL_MIN_CHUNK, total / (threads * 4));
+
+    struct Split {
+        size_t index;
+        std::vector<size_t> bounds;
+        std::vector<std::future<Chunk>> chunks;
+    };
+    std::vector<Split> splits;
+    std::vector<std::vector<Chunk>> lexed;
+    std::vector<std::future<void>> groups;
+    // Declared last so that it drains its tasks before anything they reference goes away.
+    Utils::ThreadPool pool(threads);
+    auto submitGroup = [&](std::vector<size_t> group) {
+        groups.push_back(pool.submit([&lexers, &results, group = std::move(group)] {
+            for (size_t i : group) {
+                results[i] = lexers[i].tokenize();
             }
-            backslash = (this->content[this->cursor] == '\\' ? backslash + 1 : 0);
-            value += this->content[this->cursor];
-            this->cursor++;
+        }));
+    };
+
+    // Split sources are skipped, so a group is not necessarily a contiguous range.
+    std::vector<size_t> group;
+    size_t groupBytes = 0;
+    for (size_t i = 0; i < lexers.size(); i++) {
+        const size_t bytes = lexers[i].content.size();
+        if (bytes >= 2 * target) {
+            Split split{i, lexers[i].chunkBounds(bytes / target), {}};
+            for (size_t c = 0; c + 1 < split.bounds.size(); c++) {
+                split.chunks.push_back(pool.submit([&lexer = lexers[i], from = split.bounds[c], to = split.bounds[c + 1]] {
+                    return lexer.lexChunk(from, to);
+                }));
+            }
+            splits.push_back(std::move(split));
+            continue;
         }
-        this->cursor++;
-        return {value, TK_STRING, this->line, (this->cursor - this->start_of_line) - value.size()};
+        group.push_back(i);
+        groupBytes += bytes;
+        if (groupBytes >= target) {
+            submitGroup(std::exchange(group, {}));
+            groupBytes = 0;
+        }
+    }
+    if (!group.empty()) {
+        submitGroup(std::move(group));
     }
 
-    // Identifier or keyword
-    if (Token::isSymbolStart(ch)) {
-        std::string value;
-        while (this->cursor < this->content.size() &&
-               Token::isSymbol(this->content[this->cursor])) {
-            value += this->content[this->cursor];
-            this->cursor++;
+    // Stitching waits for every chunk first so no worker blocks on a task queued behind it.
+    lexed.resize(splits.size());
+    for (size_t s = 0; s < splits.size(); s++) {
+        for (std::future<Chunk>& chunk : splits[s].chunks) {
+            lexed[s].push_back(chunk.get());
         }
-        if (Token::isAlpha(value)) {
-            TokenType type = Token::isKeyword(value);
-            if (type != TK_NOT_FOUND) {
-                return {
-                    value, type, this->line,
-                    (this->cursor - this->start_of_line) - value.size()
-                };
+    }
+    for (size_t s = 0; s < splits.size(); s++) {
+        groups.push_back(pool.submit([&, s] {
+            results[splits[s].index] = lexers[splits[s].index].stitch(lexed[s], splits[s].bounds);
+        }));
+    }
+    for (std::future<void>& group : groups) {
+        group.get();
+    }
+    return results;
+}
+
+std::vector<Lexer::LexedSource> Lexer::lexBatch(std::span<const std::string_view> sources, size_t threads) {
+    std::vector<Lexer> lexers;
+    lexers.reserve(sources.size());
+    for (std::string_view source : sources) {
+        lexers.emplace_back(source);
+    }
+    return Lexer::collect(std::move(lexers), threads);
+}
+
+std::vector<Lexer::LexedSource> Lexer::lexBatch(std::span<const std::filesystem::path> paths, size_t threads) {
+    if (threads == 0) {
+        threads = Utils::ThreadPool::defaultThreads();
+    }
+    // Opening and mapping thousands of files is syscall-bound, so that is spread over the workers too.
+    constexpr size_t FILES_PER_TASK = 64;
+    std::vector<Lexer> lexers;
+    lexers.reserve(paths.size());
+    {
+        Utils::ThreadPool pool(threads);
+        std::vector<std::future<std::vector<Lexer>>> opened;
+        for (size_t from = 0; from < paths.size(); from += FILES_PER_TASK) {
+            opened.push_back(pool.submit([paths, from, to = std::min(from + FILES_PER_TASK, paths.size())] {
+                std::vector<Lexer> group;
+                group.reserve(to - from);
+                for (size_t i = from; i < to; i++) {
+                    group.push_back(Lexer::fromFile(paths[i].string()));
+                }
+                return group;
+            }));
+        }
+        for (std::future<std::vector<Lexer>>& group : opened) {
+            for (Lexer& lexer : group.get()) {
+                lexers.push_back(std::move(lexer));
             }
-            return {value, TK_IDENTIFIER, this->line, (this->cursor - this->start_of_line) - value.size()};
         }
     }
+    return Lexer::collect(std::move(lexers), threads);
+}
 
-    // Number (integer or float)
-    if (isdigit(ch) || (ch == '.' && isdigit(this->content[this->cursor + 1]))) {
-        std::string value;
-        while ((this->cursor < this->content.size() &&
-                isalnum(this->content[this->cursor])) || this->content[this->cursor] == '-' || this->content[this->cursor] == '.' ||
-               this->content[this->cursor] == 'e' || this->content[this->cursor] == 'E' || (this->content[this->cursor] == '+' &&
-                                                                                            (this->cursor - 1 != 0 && this->content[this->cursor - 1] == 'e' || this->content[this->cursor - 1] == 'E'))) {
-            value += this->content[this->cursor];
-            this->cursor++;
+std::vector<Lexer::LexedSource> Lexer::Lexer::collect(std::vector<Lexer> lexers, size_t threads) {
+    std::vector<TokenBuffer> tokens = tokenizeEach(lexers, threads);
+    std::vector<LexedSource> results;
+    results.reserve(lexers.size());
+    for (size_t i = 0; i < lexers.size(); i++) {
+        results.push_back({std::move(lexers[i]), std::move(tokens[i])});
+    }
+    return results;
+}
+
+void Lexer::Lexer::relex(TokenBuffer& tokens, std::string_view edited, const TextEdit& edit) {
+    const std::string_view old = tokens.source();
+    if (edit.offset > old.size() || edit.removed > old.size() - edit.offset ||
+        edited.size() != old.size() - edit.removed + edit.inserted.size() ||
+        edited.substr(edit.offset, edit.inserted.size()) != edit.inserted) {
+        throw std::invalid_argument("Lexer::relex: the edit does not match the edited source");
+    }
+    const ptrdiff_t delta = static_cast<ptrdiff_t>(edit.inserted.size()) - static_cast<ptrdiff_t>(edit.removed);
+    const size_t oldEditEnd = edit.offset + edit.removed;
+    const size_t newEditEnd = edit.offset + edit.inserted.size();
+    // String tokens exclude their quotes.
+    auto spanStart = [&tokens](size_t i) {
+        return tokens.start(i) - (tokens.type(i) == TK_STRING ? 1 : 0);
+    };
+    auto spanEnd = [&tokens](size_t i) {
+        return tokens.start(i) + tokens.length(i) + (tokens.type(i) == TK_STRING ? 1 : 0);
+    };
+
+    // Restart after the last token whose lexing could not have seen the edited bytes.
+    size_t first = tokens.size();
+    for (size_t low = 0, high = tokens.size(); low < high;) {
+        size_t mid = low + (high - low) / 2;
+        if (spanEnd(mid) + TOKEN_LOOKAHEAD <= edit.offset) {
+            low = mid + 1;
+        } else {
+            high = first = mid;
         }
-        return {value, TK_NUMBER, this->line, (this->cursor - this->start_of_line) - value.size()};
     }
 
-    // Regex
-    if (ch == '/' && this->cursor + 1 < this->content.size() && this->content[this->cursor + 1] != '/' && this->content[this->cursor + 1] != '*') {
-        std::string value;
-        size_t backslash = 0;
-        this->cursor++;
-        value += '/';
-        while (this->cursor < this->content.size() &&
-               (this->content[this->cursor] != '/' || backslash % 2 != 0)) {
-            backslash = (this->content[this->cursor] == '\\' ? backslash + 1 : 0);
-            value += this->content[this->cursor];
-            this->cursor++;
+    this->content = edited;
+    this->source.reset();
+    this->cursor = first > 0 ? spanEnd(first - 1) : 0;
+
+    // Re-lex until a token past the edit matches an old token at the shifted offset; as the lexer has no
+    // state besides its cursor, everything after it is unchanged.
+    TokenBuffer fresh(edited);
+    size_t last = tokens.size();
+    size_t candidate = first;
+    while (true) {
+        Token token = this->nextToken();
+        if (token.type == TK_EOS) {
+            break;
         }
-        this->cursor++;
-        value += '/';
-        // Regex flags
-        while (this->cursor < this->content.size() && isalpha(this->content[this->cursor])) {
-            value += this->content[this->cursor];
-            this->cursor++;
+        fresh.push(token);
+        const size_t tokenStart = token.offset - (token.type == TK_STRING ? 1 : 0);
+        if (tokenStart < newEditEnd) {
+            continue;
+        }
+        const size_t oldStart = token.offset - delta;
+        while (candidate < tokens.size() && tokens.start(candidate) < oldStart) {
+            candidate++;
+        }
+        if (candidate < tokens.size() && tokens.start(candidate) == oldStart && spanStart(candidate) >= oldEditEnd &&
+            tokens.type(candidate) == token.type && tokens.length(candidate) == token.value.size()) {
+            last = candidate + 1;
+            break;
+        }
+    }
+    tokens.splice(first, last, fresh, edited, delta);
+    this->cursor = this->content.size();
+}
+
+Lexer::Lexer::Chunk Lexer::Lexer::lexChunk(size_t begin, size_t end) const {
+    Lexer lexer(this->content, this->source);
+    lexer.cursor = begin;
+    Chunk chunk{TokenBuffer(this->content), Token(), {}};
+    chunk.tokens.reserve(TokenBuffer::estimateTokens(end - begin));
+    while (true) {
+        Token token = lexer.nextToken();
+        if (token.type == TK_EOS || token.offset >= end) {
+            chunk.next = token;
+            chunk.strings = std::move(lexer.strings);
+            return chunk;
+        }
+        chunk.tokens.push(token);
+    }
+}
+
+Lexer::Token Lexer::Lexer::nextToken() {
+    const bool newline = this->skipTrivia();
+    Token token = this->lexToken();
+    token.newlineBefore = newline;
+    return token;
+}
+
+bool Lexer::Lexer::skipTrivia() {
+    bool newline = false;
+    while (true) {
+        this->leftTrim();
+        if (this->cursor >= this->content.size()) {
+            return newline;
+        }
+        const char ch = this->content[this->cursor];
+        const char next = this->cursor + 1 < this->content.size() ? this->content[this->cursor + 1] : '\0';
+        switch (charClass(ch)) {
+            case CC_NEWLINE:
+                this->skipNewlines();
+                newline = true;
+                break;
+            case CC_SLASH:
+                if (next == '/') {
+                    this->skipLineComment();
+                } else if (next == '*') {
+                    // A block comment spanning lines counts as a line terminator (ES5 7.4).
+                    newline |= this->skipBlockComment();
+                } else {
+                    return newline;
+                }
+                break;
+            case CC_UNICODE: {
+                size_t end = this->cursor;
+                const char32_t point = Unicode::decodeUtf8(this->content, end);
+                if (Unicode::isLineTerminator(point)) {
+                    newline = true;
+                } else if (!Unicode::isSpace(point)) {
+                    return newline;
+                }
+                this->cursor = end;
+                break;
+            }
+            default:
+                return newline;
+        }
+    }
+}
+
+Lexer::Token Lexer::Lexer::lexToken() {
+    if (this->cursor >= this->content.size()) {
+        return {this->view(this->content.size(), 0), TK_EOS, static_cast<uint32_t>(this->content.size())};
+    }
+    const char ch = this->content[this->cursor];
+    const char next = this->cursor + 1 < this->content.size() ? this->content[this->cursor + 1] : '\0';
+
+    switch (charClass(ch)) {
+        case CC_QUOTE:
+            return this->lexString(ch);
+        case CC_IDENT:
+            return this->lexIdentifier(this->cursor + 1);
+        case CC_DIGIT:
+            return this->lexNumber();
+        case CC_DOT:
+            if (charClass(next) == CC_DIGIT) {
+                return this->lexNumber();
+            }
+            return this->lexOperator();
+        case CC_SLASH:
+            if (next != '\0') {
+                return this->lexRegex();
+            }
+            return this->lexOperator();
+        case CC_PUNCT:
+            return this->lexOperator();
+        case CC_UNICODE: {
+            size_t end = this->cursor;
+            if (Unicode::isIdStart(Unicode::decodeUtf8(this->content, end))) {
+                return this->lexIdentifier(end);
+            }
+            return this->lexIllegal(end);
+        }
+        default:
+            return this->lexIllegal(this->cursor + 1);
+    }
+}
+
+Lexer::Token Lexer::Lexer::lexIllegal(size_t end) {
+    size_t start = this->cursor;
+    this->cursor = end;
+    return {this->view(start, end - start), TK_ILLEGAL, static_cast<uint32_t>(start)};
+}
+
+void Lexer::Lexer::skipLineComment() {
+    this->cursor = findLineTerminator(this->content, this->cursor + 2, this->content.size());
+}
+
+bool Lexer::Lexer::skipBlockComment() {
+    size_t start = this->cursor + 2;
+    size_t end = Scan::findCommentEnd(this->content, start);
+    this->cursor = std::min(end + 2, this->content.size());
+    return findLineTerminator(this->content, start, end) < end;
+}
+
+void Lexer::Lexer::skipNewlines() {
+    // "\n", "\r\n" and a lone "\r" are all line terminators.
+    while (this->cursor < this->content.size() && charClass(this->content[this->cursor]) == CC_NEWLINE) {
+        const bool crlf = this->content[this->cursor] == '\r' &&
+                          this->cursor + 1 < this->content.size() && this->content[this->cursor + 1] == '\n';
+        this->cursor += (crlf ? 2 : 1);
+    }
+}
+
+Lexer::Token Lexer::Lexer::lexString(char quote) {
+    size_t start = ++this->cursor;
+    while (true) {
+        this->cursor = Scan::findQuoteOrBackslash(this->content, this->cursor, quote);
+        if (this->cursor >= this->content.size() || this->content[this->cursor] == quote) {
+            break;
         }
-        return {value, TK_REGEXP, this->line, (this->cursor - this->start_of_line) - value.size()};
+        this->cursor = std::min(this->cursor + 2, this->content.size()); // skip the escaped character
     }
+    std::string_view value = this->view(start, this->cursor - start);
+    this->cursor++;
+    Token token(value, TK_STRING, static_cast<uint32_t>(start));
+    // Fast path: plain ASCII without escapes is its own decoded value, nothing to copy.
+    if (!isPlainAscii(value)) {
+        token.decoded = this->decodeString(value);
+    }
+    return token;
+}
 
-    for (size_t i = TK_QUAD_OP_LAST; i > TK_SIMPLE_OP_FIRST; i--) {
-        if (TokenValue[i] == nullptr) {
+std::u16string_view Lexer::Lexer::decodeString(std::string_view raw) {
+    // One buffer per thread, shared by every lexer that thread runs (batches create many short-lived ones).
+    thread_local std::u16string scratch;
+    std::u16string& out = scratch;
+    out.clear();
+    for (size_t i = 0; i < raw.size();) {
+        const unsigned char ch = raw[i];
+        if (ch >= 0x80) {
+            Unicode::appendUtf16(out, Unicode::decodeUtf8(raw, i));
+            continue;
+        }
+        if (ch != '\\' || i + 1 >= raw.size()) {
+            out += static_cast<char16_t>(ch);
+            i++;
             continue;
         }
-        if (this->content.compare(this->cursor, strlen(TokenValue[i]), TokenValue[i]) == 0) {
-            this->cursor += strlen(TokenValue[i]);
-            return {TokenValue[i], static_cast<TokenType>(i), this->line, (this->cursor - this->start_of_line) - strlen(TokenValue[i])};
+        const char escape = raw[i + 1];
+        i += 2;
+        switch (escape) {
+            case 'b': out += u'\b'; break;
+            case 't': out += u'\t'; break;
+            case 'n': out += u'\n'; break;
+            case 'v': out += u'\v'; break;
+            case 'f': out += u'\f'; break;
+            case 'r': out += u'\r'; break;
+            case '\r':
+                // Line continuation, "\r\n" included.
+                i += (i < raw.size() && raw[i] == '\n');
+                break;
+            case '\n':
+                break;
+            case 'x':
+            case 'u': {
+                const size_t digits = escape == 'x' ? 2 : 4;
+                char32_t unit = 0;
+                size_t read = 0;
+                for (; read < digits && i + read < raw.size() && isHexDigit(raw[i + read]); read++) {
+                    unit = unit * 16 + hexValue(raw[i + read]);
+                }
+                if (read == digits) {
+                    out += static_cast<char16_t>(unit);
+                    i += digits;
+                } else {
+                    out += static_cast<char16_t>(escape); // malformed, keep the letter like other engines
+                }
+                break;
+            }
+            default:
+                if (escape >= '0' && escape <= '7') {
+                    // Legacy octal escape, up to three digits and at most \377.
+                    unsigned unit = escape - '0';
+                    const size_t limit = escape <= '3' ? 2 : 1;
+                    for (size_t read = 0; read < limit && i < raw.size() && raw[i] >= '0' && raw[i] <= '7'; read++) {
+                        unit = unit * 8 + (raw[i++] - '0');
+                    }
+                    out += static_cast<char16_t>(unit);
+                } else if (static_cast<unsigned char>(escape) >= 0x80) {
+                    i--;
+                    Unicode::appendUtf16(out, Unicode::decodeUtf8(raw, i));
+                } else {
+                    out += static_cast<char16_t>(escape);
+                }
+        }
+    }
+    return *this->strings.emplace_back(std::make_unique<const std::u16string>(out));
+}
+
+Lexer::Token Lexer::Lexer::lexIdentifier(size_t firstEnd) {
+    size_t start = this->cursor;
+    this->cursor = Scan::findNonIdentifier(this->content, firstEnd);
+    // Slow path, only once a non-ASCII byte shows up.
+    while (this->cursor < this->content.size() && charClass(this->content[this->cursor]) == CC_UNICODE) {
+        size_t end = this->cursor;
+        if (!Unicode::isIdPart(Unicode::decodeUtf8(this->content, end))) {
+            break;
+        }
+        this->cursor = Scan::findNonIdentifier(this->content, end);
+    }
+    std::string_view value = this->view(start, this->cursor - start);
+    TokenType type = Token::isKeyword(value);
+    return {value, type != TK_NOT_FOUND ? type : TK_IDENTIFIER, static_cast<uint32_t>(start)};
+}
+
+Lexer::Token Lexer::Lexer::lexNumber() {
+    size_t start = this->cursor;
+    double number = 0;
+    bool fraction = false;
+    const char* text = this->content.data();
+    const size_t size = this->content.size();
+    if (text[start] == '0' && start + 2 < size && (text[start + 1] | 0x20) == 'x' && isHexDigit(text[start + 2])) {
+        this->cursor += 2;
+        for (; this->cursor < size && isHexDigit(text[this->cursor]); this->cursor++) {
+            number = number * 16 + hexValue(text[this->cursor]);
+        }
+    } else if (text[start] == '0' && start + 1 < size && charClass(text[start + 1]) == CC_DIGIT) {
+        // Legacy octal (ES5 Annex B): "010" is 8, as it is in the emitted C++. ES5 has no "08" or "09", the
+        // trailing digit makes them illegal below.
+        for (this->cursor++; this->cursor < size && text[this->cursor] >= '0' && text[this->cursor] <= '7';
+             this->cursor++) {
+            number = number * 8 + (text[this->cursor] - '0');
+        }
+    } else {
+        this->skipDigits();
+        if (this->cursor < size && text[this->cursor] == '.') {
+            fraction = true;
+            this->cursor++;
+            this->skipDigits();
+        }
+        if (this->cursor < size && (text[this->cursor] | 0x20) == 'e') {
+            size_t digits = this->cursor + 1;
+            if (digits < size && (text[digits] == '+' || text[digits] == '-')) {
+                digits++;
+            }
+            if (digits < size && charClass(text[digits]) == CC_DIGIT) {
+                fraction = true;
+                this->cursor = digits;
+                this->skipDigits();
+            }
+        }
+        std::from_chars(text + start, text + this->cursor, number);
+    }
+
+    // A literal must not run straight into an identifier, a digit or another fraction ("3in", "1.2.3").
+    const bool trailingFraction = fraction && this->cursor + 1 < size && text[this->cursor] == '.' &&
+                                  charClass(text[this->cursor + 1]) == CC_DIGIT;
+    if (this->cursor < size && (Token::isSymbol(text[this->cursor]) || trailingFraction)) {
+        while (this->cursor < size && (Token::isSymbol(text[this->cursor]) || text[this->cursor] == '.')) {
+            this->cursor++;
         }
+        return {this->view(start, this->cursor - start), TK_ILLEGAL, static_cast<uint32_t>(start)};
+    }
+    Token token(this->view(start, this->cursor - start), TK_NUMBER, static_cast<uint32_t>(start));
+    token.number = number;
+    return token;
+}
+
+void Lexer::Lexer::skipDigits() {
+    while (this->cursor < this->content.size() && charClass(this->content[this->cursor]) == CC_DIGIT) {
+        this->cursor++;
     }
-    return {};
-}
\ No newline at end of file
+}
+
+Lexer::Token Lexer::Lexer::lexRegex() {
+    size_t start = this->cursor;
+    size_t backslash = 0;
+    this->cursor++;
+    while (this->cursor < this->content.size() &&
+           (this->content[this->cursor] != '/' || backslash % 2 != 0)) {
+        backslash = (this->content[this->cursor] == '\\' ? backslash + 1 : 0);
+        this->cursor++;
+    }
+    this->cursor++;
+    // Regex flags
+    while (this->cursor < this->content.size() && isAsciiAlpha(this->content[this->cursor])) {
+        this->cursor++;
+    }
+    return {this->view(start, this->cursor - start), TK_REGEXP, static_cast<uint32_t>(start)};
+}
+
+Lexer::Token Lexer::Lexer::lexOperator() {
+    size_t length = 0;
+    TokenType type = Token::matchOperator(this->content.substr(this->cursor), length);
+    if (type == TK_NOT_FOUND) {
+        return {};
+    }
+    std::string_view value = this->view(this->cursor, length);
+    this->cursor += length;
+    return {value, type, static_cast<uint32_t>(this->cursor - length)};
+}
@@ -0,0 +1,41 @@
+#include "../../include/Tokenizer/LineIndex.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include "../../include/Tokenizer/Scanner.hpp"
+
+Lexer::LineIndex::LineIndex(std::string_view source)
+    : source(source) {
+}
+
+Lexer::SourceLocation Lexer::LineIndex::locate(size_t offset) const {
+    std::call_once(this->built, [this] { this->build(); });
+    offset = std::min(offset, this->source.size());
+    auto next = std::upper_bound(this->starts.begin(), this->starts.end(), offset);
+    size_t line = static_cast<size_t>(next - this->starts.begin()) - 1;
+    return {line, offset - this->starts[line]};
+}
+
+size_t Lexer::LineIndex::lineCount() const {
+    std::call_once(this->built, [this] { this->build(); });
+    return this->starts.size();
+}
+
+void Lexer::LineIndex::build() const {
+    this->starts.push_back(0);
+    if (std::memchr(this->source.data(), '\r', this->source.size()) == nullptr) {
+        // Common case: only '\n' terminators, let the block kernel skip the line bodies.
+        size_t cursor = Scan::findNewline(this->source, 0);
+        while (cursor < this->source.size()) {
+            this->starts.push_back(static_cast<uint32_t>(cursor + 1));
+            cursor = Scan::findNewline(this->source, cursor + 1);
+        }
+        return;
+    }
+    for (size_t i = 0; i < this->source.size(); i++) {
+        const char ch = this->source[i];
+        if (ch == '\n' || (ch == '\r' && (i + 1 >= this->source.size() || this->source[i + 1] != '\n'))) {
+            this->starts.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+}
@@ -0,0 +1,352 @@
+#include "../../include/Tokenizer/Scanner.hpp"
+#include "../../include/Tokenizer/Token.hpp"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JS_CMP_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+using Kernel = size_t (*)(const char* data, size_t size, size_t from);
+using QuoteKernel = size_t (*)(const char* data, size_t size, size_t from, char quote);
+
+struct Kernels {
+    Kernel newline;
+    Kernel commentEnd;
+    QuoteKernel quoteOrBackslash;
+    Kernel nonIdentifier;
+    Kernel nonSpace;
+};
+
+// Scalar fallback
+
+size_t scalarNewline(const char* data, size_t size, size_t from) {
+    const void* hit = std::memchr(data + from, '\n', size - from);
+    return hit != nullptr ? static_cast<const char*>(hit) - data : size;
+}
+
+size_t scalarCommentEnd(const char* data, size_t size, size_t from) {
+    for (size_t i = from; i + 1 < size; i++) {
+        if (data[i] == '*' && data[i + 1] == '/') {
+            return i;
+        }
+    }
+    return size;
+}
+
+size_t scalarQuoteOrBackslash(const char* data, size_t size, size_t from, char quote) {
+    for (size_t i = from; i < size; i++) {
+        if (data[i] == quote || data[i] == '\\') {
+            return i;
+        }
+    }
+    return size;
+}
+
+size_t scalarNonIdentifier(const char* data, size_t size, size_t from) {
+    for (size_t i = from; i < size; i++) {
+        if (!Lexer::Token::isSymbol(data[i])) {
+            return i;
+        }
+    }
+    return size;
+}
+
+size_t scalarNonSpace(const char* data, size_t size, size_t from) {
+    for (size_t i = from; i < size; i++) {
+        if (!Lexer::Token::isSkippable(data[i])) {
+            return i;
+        }
+    }
+    return size;
+}
+
+constexpr Kernels SCALAR_KERNELS = {
+    scalarNewline, scalarCommentEnd, scalarQuoteOrBackslash, scalarNonIdentifier, scalarNonSpace
+};
+
+#ifdef JS_CMP_SCAN_X86
+
+// SSE2: 16 bytes per step. Unsigned range checks are done as signed compares after flipping the sign bit.
+
+#define SSE2 __attribute__((target("sse2")))
+
+SSE2 inline __m128i sse2InRange(__m128i v, char low, char count) {
+    const __m128i offset = _mm_xor_si128(_mm_sub_epi8(v, _mm_set1_epi8(low)), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_cmplt_epi8(offset, _mm_set1_epi8(static_cast<char>(count ^ 0x80)));
+}
+
+SSE2 inline unsigned sse2IdentifierMask(__m128i v) {
+    __m128i ident = _mm_or_si128(sse2InRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26), sse2InRange(v, '0', 10));
+    ident = _mm_or_si128(ident, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')), _mm_cmpeq_epi8(v, _mm_set1_epi8('$'))));
+    return static_cast<unsigned>(_mm_movemask_epi8(ident));
+}
+
+SSE2 inline unsigned sse2SpaceMask(__m128i v) {
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+    space = _mm_or_si128(space, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\v')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\f'))));
+    return static_cast<unsigned>(_mm_movemask_epi8(space));
+}
+
+SSE2 inline __m128i sse2Load(const char* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+SSE2 size_t sse2Newline(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 16 <= size; i += 16) {
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(sse2Load(data + i), _mm_set1_epi8('\n')));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return scalarNewline(data, size, i);
+}
+
+SSE2 size_t sse2CommentEnd(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 17 <= size; i += 16) {
+        __m128i star = _mm_cmpeq_epi8(sse2Load(data + i), _mm_set1_epi8('*'));
+        __m128i slash = _mm_cmpeq_epi8(sse2Load(data + i + 1), _mm_set1_epi8('/'));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(star, slash));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return scalarCommentEnd(data, size, i);
+}
+
+SSE2 size_t sse2QuoteOrBackslash(const char* data, size_t size, size_t from, char quote) {
+    size_t i = from;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = sse2Load(data + i);
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(quote)), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return scalarQuoteOrBackslash(data, size, i, quote);
+}
+
+SSE2 size_t sse2NonIdentifier(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 16 <= size; i += 16) {
+        unsigned mask = ~sse2IdentifierMask(sse2Load(data + i)) & 0xffffu;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return scalarNonIdentifier(data, size, i);
+}
+
+SSE2 size_t sse2NonSpace(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 16 <= size; i += 16) {
+        unsigned mask = ~sse2SpaceMask(sse2Load(data + i)) & 0xffffu;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return scalarNonSpace(data, size, i);
+}
+
+#undef SSE2
+
+constexpr Kernels SSE2_KERNELS = {
+    sse2Newline, sse2CommentEnd, sse2QuoteOrBackslash, sse2NonIdentifier, sse2NonSpace
+};
+
+// AVX2: same kernels, 32 bytes per step.
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 inline __m256i avx2InRange(__m256i v, char low, char count) {
+    const __m256i offset = _mm256_xor_si256(_mm256_sub_epi8(v, _mm256_set1_epi8(low)), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(count ^ 0x80)), offset);
+}
+
+AVX2 inline uint32_t avx2IdentifierMask(__m256i v) {
+    __m256i ident = _mm256_or_si256(avx2InRange(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 26), avx2InRange(v, '0', 10));
+    ident = _mm256_or_si256(ident, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('$'))));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(ident));
+}
+
+AVX2 inline uint32_t avx2SpaceMask(__m256i v) {
+    __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+    space = _mm256_or_si256(space, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\v')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\f'))));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(space));
+}
+
+AVX2 inline __m256i avx2Load(const char* data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+}
+
+AVX2 size_t avx2Newline(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 32 <= size; i += 32) {
+        uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(avx2Load(data + i), _mm256_set1_epi8('\n')));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return sse2Newline(data, size, i);
+}
+
+AVX2 size_t avx2CommentEnd(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 33 <= size; i += 32) {
+        __m256i star = _mm256_cmpeq_epi8(avx2Load(data + i), _mm256_set1_epi8('*'));
+        __m256i slash = _mm256_cmpeq_epi8(avx2Load(data + i + 1), _mm256_set1_epi8('/'));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(star, slash));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return sse2CommentEnd(data, size, i);
+}
+
+AVX2 size_t avx2QuoteOrBackslash(const char* data, size_t size, size_t from, char quote) {
+    size_t i = from;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = avx2Load(data + i);
+        uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(quote)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return sse2QuoteOrBackslash(data, size, i, quote);
+}
+
+AVX2 size_t avx2NonIdentifier(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 32 <= size; i += 32) {
+        uint32_t mask = ~avx2IdentifierMask(avx2Load(data + i));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return sse2NonIdentifier(data, size, i);
+}
+
+AVX2 size_t avx2NonSpace(const char* data, size_t size, size_t from) {
+    size_t i = from;
+    for (; i + 32 <= size; i += 32) {
+        uint32_t mask = ~avx2SpaceMask(avx2Load(data + i));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return sse2NonSpace(data, size, i);
+}
+
+#undef AVX2
+
+constexpr Kernels AVX2_KERNELS = {
+    avx2Newline, avx2CommentEnd, avx2QuoteOrBackslash, avx2NonIdentifier, avx2NonSpace
+};
+
+#endif
+
+bool supported(Lexer::Scan::Isa isa) {
+    switch (isa) {
+        case Lexer::Scan::Isa::SCALAR:
+            return true;
+#ifdef JS_CMP_SCAN_X86
+        case Lexer::Scan::Isa::SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case Lexer::Scan::Isa::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const Kernels* kernelsFor(Lexer::Scan::Isa isa) {
+    switch (isa) {
+#ifdef JS_CMP_SCAN_X86
+        case Lexer::Scan::Isa::SSE2:
+            return &SSE2_KERNELS;
+        case Lexer::Scan::Isa::AVX2:
+            return &AVX2_KERNELS;
+#endif
+        default:
+            return &SCALAR_KERNELS;
+    }
+}
+
+struct ActiveKernels {
+    std::atomic<const Kernels*> kernels;
+    std::atomic<Lexer::Scan::Isa> isa;
+};
+
+ActiveKernels& active() {
+    static ActiveKernels current{kernelsFor(Lexer::Scan::bestIsa()), Lexer::Scan::bestIsa()};
+    return current;
+}
+
+const Kernels& kernels() {
+    return *active().kernels.load(std::memory_order_relaxed);
+}
+}
+
+namespace Lexer::Scan {
+Isa bestIsa() {
+    if (supported(Isa::AVX2)) {
+        return Isa::AVX2;
+    }
+    if (supported(Isa::SSE2)) {
+        return Isa::SSE2;
+    }
+    return Isa::SCALAR;
+}
+
+Isa activeIsa() {
+    return active().isa.load(std::memory_order_relaxed);
+}
+
+bool useIsa(Isa isa) {
+    if (!supported(isa)) {
+        return false;
+    }
+    active().kernels.store(kernelsFor(isa), std::memory_order_relaxed);
+    active().isa.store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SSE2:
+            return "sse2";
+        case Isa::AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+size_t findNewline(std::string_view text, size_t from) {
+    return from < text.size() ? kernels().newline(text.data(), text.size(), from) : text.size();
+}
+
+size_t findCommentEnd(std::string_view text, size_t from) {
+    return from < text.size() ? kernels().commentEnd(text.data(), text.size(), from) : text.size();
+}
+
+size_t findQuoteOrBackslash(std::string_view text, size_t from, char quote) {
+    return from < text.size() ? kernels().quoteOrBackslash(text.data(), text.size(), from, quote) : text.size();
+}
+
+size_t findNonIdentifier(std::string_view text, size_t from) {
+    return from < text.size() ? kernels().nonIdentifier(text.data(), text.size(), from) : text.size();
+}
+
+size_t findNonSpace(std::string_view text, size_t from) {
+    return from < text.size() ? kernels().nonSpace(text.data(), text.size(), from) : text.size();
+}
+}
@@ -0,0 +1,58 @@
+#include "../../include/Tokenizer/Symbol.hpp"
+
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+Lexer::Symbol Lexer::Symbol::intern(std::string_view name) {
+    return SymbolTable::global().intern(name);
+}
+
+std::string_view Lexer::Symbol::str() const {
+    return SymbolTable::global().name(*this);
+}
+
+Lexer::SymbolTable& Lexer::SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+Lexer::SymbolTable::SymbolTable()
+    : names{std::string_view()} {
+}
+
+Lexer::Symbol Lexer::SymbolTable::intern(std::string_view name) {
+    if (name.empty()) {
+        return {};
+    }
+    {
+        std::shared_lock lock(this->mutex);
+        auto it = this->ids.find(name);
+        if (it != this->ids.end()) {
+            return Symbol(it->second);
+        }
+    }
+    std::unique_lock lock(this->mutex);
+    auto it = this->ids.find(name); // another thread may have added it meanwhile
+    if (it != this->ids.end()) {
+        return Symbol(it->second);
+    }
+    if (this->names.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("SymbolTable: too many distinct names");
+    }
+    std::string_view stored = this->storage.emplace_back(name);
+    uint32_t index = static_cast<uint32_t>(this->names.size());
+    this->names.push_back(stored);
+    this->ids.emplace(stored, index);
+    return Symbol(index);
+}
+
+std::string_view Lexer::SymbolTable::name(Symbol symbol) const {
+    std::shared_lock lock(this->mutex);
+    return this->names[symbol.index];
+}
+
+size_t Lexer::SymbolTable::size() const {
+    std::shared_lock lock(this->mutex);
+    return this->names.size();
+}
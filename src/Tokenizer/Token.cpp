@@ -1,70 +1,231 @@
 #include "../../include/Tokenizer/Token.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <utility>
 #include <iostream>
 
+namespace {
+// Keywords are the named entries of TOKENS(X) between the operators and the literals.
+constexpr size_t KEYWORD_FIRST = Lexer::TK_QUAD_OP_LAST + 1;
+constexpr size_t KEYWORD_LAST = Lexer::TK_NUMBER;
+constexpr size_t KEYWORD_SLOTS = 128;
+
+static_assert(Lexer::TK_NUM_TOKENS < 256, "token types must fit the uint8_t keyword slots");
+
+constexpr uint32_t keywordHash(std::string_view word, uint32_t seed) {
+    uint32_t hash = static_cast<uint32_t>(word.size());
+    hash = hash * seed + static_cast<unsigned char>(word[0]);
+    hash = hash * seed + static_cast<unsigned char>(word[1]);
+    hash = hash * seed + static_cast<unsigned char>(word.back());
+    return (hash ^ (hash >> 7)) % KEYWORD_SLOTS;
+}
+
+/** Collision-free open table: each keyword owns one slot, so a lookup is one hash and one compare. */
+struct KeywordTable {
+    uint32_t seed = 0;
+    size_t minLength = SIZE_MAX;
+    size_t maxLength = 0;
+    std::array<uint8_t, KEYWORD_SLOTS> types{};
+    std::array<uint8_t, KEYWORD_SLOTS> lengths{};
+};
+
+constexpr KeywordTable buildKeywordTable() {
+    for (uint32_t seed = 1; seed < 4096; seed++) {
+        KeywordTable table;
+        table.seed = seed;
+        bool perfect = true;
+        for (size_t i = KEYWORD_FIRST; i < KEYWORD_LAST && perfect; i++) {
+            if (Lexer::TokenValue[i] == nullptr) {
+                continue;
+            }
+            std::string_view keyword = Lexer::TokenValue[i];
+            uint32_t slot = keywordHash(keyword, seed);
+            if (table.types[slot] != 0) {
+                perfect = false;
+                break;
+            }
+            table.types[slot] = static_cast<uint8_t>(i);
+            table.lengths[slot] = static_cast<uint8_t>(keyword.size());
+            table.minLength = std::min(table.minLength, keyword.size());
+            table.maxLength = std::max(table.maxLength, keyword.size());
+        }
+        if (perfect) {
+            return table;
+        }
+    }
+    return {};
+}
+
+constexpr KeywordTable KEYWORDS = buildKeywordTable();
+static_assert(KEYWORDS.seed != 0, "no collision-free seed found for the keyword table");
+static_assert(KEYWORDS.minLength >= 2, "keywordHash reads the first two characters");
+
+// Operators are the named entries of TOKENS(X) between TK_SIMPLE_OP_FIRST and TK_QUAD_OP_LAST.
+constexpr size_t OPERATOR_FIRST = Lexer::TK_SIMPLE_OP_FIRST + 1;
+constexpr size_t OPERATOR_LAST = Lexer::TK_QUAD_OP_LAST;
+
+constexpr size_t operatorNodeBound() {
+    size_t nodes = 1;
+    for (size_t i = OPERATOR_FIRST; i < OPERATOR_LAST; i++) {
+        if (Lexer::TokenValue[i] != nullptr) {
+            nodes += std::string_view(Lexer::TokenValue[i]).size();
+        }
+    }
+    return nodes;
+}
+
+/** Maps each byte that can appear in an operator to a dense edge index (0 = not an operator byte). */
+constexpr std::array<uint8_t, 256> buildOperatorClasses() {
+    std::array<uint8_t, 256> classes{};
+    uint8_t next = 1;
+    for (size_t i = OPERATOR_FIRST; i < OPERATOR_LAST; i++) {
+        if (Lexer::TokenValue[i] == nullptr) {
+            continue;
+        }
+        for (const char ch : std::string_view(Lexer::TokenValue[i])) {
+            if (classes[static_cast<unsigned char>(ch)] == 0) {
+                classes[static_cast<unsigned char>(ch)] = next++;
+            }
+        }
+    }
+    return classes;
+}
+
+constexpr std::array<uint8_t, 256> OPERATOR_CLASSES = buildOperatorClasses();
+
+constexpr size_t operatorClassCount() {
+    size_t count = 0;
+    for (const uint8_t cls : OPERATOR_CLASSES) {
+        count = std::max<size_t>(count, cls);
+    }
+    return count + 1;
+}
+
+constexpr size_t OPERATOR_NODES = operatorNodeBound();
+constexpr size_t OPERATOR_EDGES = operatorClassCount();
+static_assert(OPERATOR_NODES < 256, "operator trie nodes must fit uint8_t edges");
+
+/** Trie over every operator spelling; node 0 is the root and an edge to 0 means no transition. */
+struct OperatorTrie {
+    std::array<std::array<uint8_t, OPERATOR_EDGES>, OPERATOR_NODES> next{};
+    std::array<uint8_t, OPERATOR_NODES> types{};
+    size_t maxLength = 0;
+};
+
+constexpr OperatorTrie buildOperatorTrie() {
+    OperatorTrie trie;
+    size_t used = 1;
+    for (size_t i = OPERATOR_FIRST; i < OPERATOR_LAST; i++) {
+        if (Lexer::TokenValue[i] == nullptr) {
+            continue;
+        }
+        std::string_view op = Lexer::TokenValue[i];
+        size_t node = 0;
+        for (const char ch : op) {
+            uint8_t& edge = trie.next[node][OPERATOR_CLASSES[static_cast<unsigned char>(ch)]];
+            if (edge == 0) {
+                edge = static_cast<uint8_t>(used++);
+            }
+            node = edge;
+        }
+        trie.types[node] = static_cast<uint8_t>(i);
+        trie.maxLength = std::max(trie.maxLength, op.size());
+    }
+    return trie;
+}
+
+constexpr OperatorTrie OPERATORS = buildOperatorTrie();
+}
+
 Lexer::Token::Token()
     : value(),
       type(TK_EOS),
-      line(0),
-      column(0)
+      offset(0)
 {
 }
 
-Lexer::Token::Token(Lexer::TokenType type) : value(), type(type), line(0), column(0)
+Lexer::Token::Token(Lexer::TokenType type) : value(), type(type), offset(0)
 {
 }
 
 Lexer::Token::Token(
-    std::string value, TokenType type, unsigned long line, unsigned long column
+    std::string_view value, TokenType type, uint32_t offset
 )
-    : value(std::move(value)),
+    : value(value),
       type(type),
-      line(line),
-      column(column)
+      offset(offset)
 {
 }
 
-bool Lexer::Token::isSkippable(char ch)
+bool Lexer::Token::isAlpha(std::string_view str)
 {
-    return ch == ' ' || ch == '\t';
+    if (str.empty()) {
+        return false;
+    }
+    for (const char ch: str) {
+        if (!isSymbol(ch)) {
+            return false;
+        }
+    }
+    return true;
 }
 
-bool Lexer::Token::isSymbolStart(char ch)
+Lexer::TokenType Lexer::Token::isKeyword(std::string_view str)
 {
-    return isalpha(ch) || ch == '_' || ch == '$';
+    if (str.size() < KEYWORDS.minLength || str.size() > KEYWORDS.maxLength) {
+        return TK_NOT_FOUND;
+    }
+    uint32_t slot = keywordHash(str, KEYWORDS.seed);
+    if (KEYWORDS.types[slot] == 0 || KEYWORDS.lengths[slot] != str.size() ||
+        std::char_traits<char>::compare(str.data(), TokenValue[KEYWORDS.types[slot]], str.size()) != 0) {
+        return TK_NOT_FOUND;
+    }
+    return static_cast<TokenType>(KEYWORDS.types[slot]);
 }
 
-bool Lexer::Token::isSymbol(char ch)
+Lexer::TokenType Lexer::Token::matchOperator(std::string_view str, size_t& length)
 {
-    return isalnum(ch) || ch == '_' || ch == '$';
+    TokenType type = TK_NOT_FOUND;
+    size_t node = 0;
+    const size_t limit = std::min(str.size(), OPERATORS.maxLength);
+    for (size_t i = 0; i < limit; i++) {
+        uint8_t cls = OPERATOR_CLASSES[static_cast<unsigned char>(str[i])];
+        node = OPERATORS.next[node][cls];
+        if (cls == 0 || node == 0) {
+            break;
+        }
+        if (OPERATORS.types[node] != 0) {
+            type = static_cast<TokenType>(OPERATORS.types[node]);
+            length = i + 1;
+        }
+    }
+    return type;
 }
 
-bool Lexer::Token::isAlpha(const std::string &str)
+std::string Lexer::Token::str() const
 {
-    if (str.empty()) {
-        return false;
-    }
-    if (!(isalpha(str[0]) || str[0] != '_' || str[0] != '$')){
-        return false;
+    if (this->type != TK_STRING || this->value.data() == nullptr) {
+        return std::string(this->value);
     }
-    for (const char ch: str) {
-        if (!(isalnum(ch) || ch == '_' || ch == '$')) {
-            return false;
+    // String literal views start right after their opening quote.
+    const char quote = this->value.data()[-1];
+    const char other = (quote == '\'' ? '"' : '\'');
+    std::string text;
+    text.reserve(this->value.size());
+    for (const char ch : this->value) {
+        if (ch == other) {
+            text += '\\';
         }
+        text += ch;
     }
-    return true;
+    return text;
 }
 
-Lexer::TokenType Lexer::Token::isKeyword(const std::string &str)
+std::u16string Lexer::Token::utf16() const
 {
-    for (int i = TK_QUAD_OP_LAST + 1; i < TK_NUMBER; i++) {
-        if (TokenValue[i] == nullptr) {
-            continue;
-        }
-        if (str == TokenValue[i]) {
-            return static_cast<TokenType>(i);
-        }
+    if (this->decoded.data() != nullptr) {
+        return std::u16string(this->decoded);
     }
-    return TK_NOT_FOUND;
-}
\ No newline at end of file
+    return std::u16string(this->value.begin(), this->value.end());
+}
@@ -0,0 +1,90 @@
+#include "../../include/Tokenizer/TokenBuffer.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+Lexer::TokenBuffer::TokenBuffer()
+    : TokenBuffer(std::string_view()) {
+}
+
+Lexer::TokenBuffer::TokenBuffer(std::string_view source)
+    : text(source),
+      lineIndex(std::make_shared<const LineIndex>(source)) {
+    if (source.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("TokenBuffer: sources larger than 4 GiB are not supported");
+    }
+}
+
+size_t Lexer::TokenBuffer::estimateTokens(size_t bytes) {
+    // Real-world JS averages a token every 4-6 bytes once whitespace is counted.
+    return bytes / 5 + 16;
+}
+
+void Lexer::TokenBuffer::reserve(size_t count) {
+    this->types.reserve(count);
+    this->starts.reserve(count);
+    this->lengths.reserve(count);
+}
+
+void Lexer::TokenBuffer::push(const Token& token) {
+    this->types.push_back(static_cast<uint8_t>(token.type) | (token.newlineBefore ? NEWLINE_BEFORE : 0));
+    this->starts.push_back(token.offset);
+    this->lengths.push_back(static_cast<uint32_t>(token.value.size()));
+    if (token.type == TK_NUMBER) {
+        this->numbers.indices.push_back(static_cast<uint32_t>(this->types.size() - 1));
+        this->numbers.values.push_back(token.number);
+    } else if (token.type == TK_STRING && token.decoded.data() != nullptr) {
+        this->strings.indices.push_back(static_cast<uint32_t>(this->types.size() - 1));
+        this->strings.values.push_back(token.decoded);
+    }
+}
+
+void Lexer::TokenBuffer::append(const TokenBuffer& other, size_t from) {
+    if (other.text.data() != this->text.data()) {
+        throw std::invalid_argument("TokenBuffer: cannot append tokens lexed from another source");
+    }
+    from = std::min(from, other.size());
+    this->numbers.append(other.numbers, from, this->size());
+    this->strings.append(other.strings, from, this->size());
+    this->types.insert(this->types.end(), other.types.begin() + from, other.types.end());
+    this->starts.insert(this->starts.end(), other.starts.begin() + from, other.starts.end());
+    this->lengths.insert(this->lengths.end(), other.lengths.begin() + from, other.lengths.end());
+}
+
+size_t Lexer::TokenBuffer::find(uint32_t offset) const {
+    auto it = std::lower_bound(this->starts.begin(), this->starts.end(), offset);
+    return it != this->starts.end() && *it == offset ? static_cast<size_t>(it - this->starts.begin()) : this->size();
+}
+
+void Lexer::TokenBuffer::splice(size_t first, size_t last, const TokenBuffer& replacement, std::string_view source,
+                                ptrdiff_t delta) {
+    if (source.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("TokenBuffer: sources larger than 4 GiB are not supported");
+    }
+    if (replacement.text.data() != source.data()) {
+        throw std::invalid_argument("TokenBuffer: the replacement tokens must be lexed from the new source");
+    }
+    last = std::min(last, this->size());
+    first = std::min(first, last);
+    this->numbers.splice(first, last, replacement.numbers, replacement.size());
+    this->strings.splice(first, last, replacement.strings, replacement.size());
+    for (size_t i = last; i < this->starts.size(); i++) {
+        this->starts[i] = static_cast<uint32_t>(this->starts[i] + delta);
+    }
+    // Grow or shrink the replaced range in place, so that the tail moves at most once.
+    auto replace = [first, last](auto& array, const auto& with) {
+        const size_t count = with.size();
+        if (count > last - first) {
+            array.insert(array.begin() + last, count - (last - first), {});
+        } else {
+            array.erase(array.begin() + first + count, array.begin() + last);
+        }
+        std::copy(with.begin(), with.end(), array.begin() + first);
+    };
+    replace(this->types, replacement.types);
+    replace(this->starts, replacement.starts);
+    replace(this->lengths, replacement.lengths);
+    this->text = source;
+    this->lineIndex = std::make_shared<const LineIndex>(source);
+}
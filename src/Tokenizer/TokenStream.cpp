@@ -0,0 +1,48 @@
+#include "../../include/Tokenizer/TokenStream.hpp"
+
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include "../../include/Tokenizer/Lexer.hpp"
+
+Lexer::TokenStream::TokenStream(const TokenBuffer& tokens)
+    : buffer(&tokens) {
+}
+
+Lexer::TokenStream::TokenStream(Lexer& lexer, size_t window)
+    : lexer(&lexer),
+      lineIndex(std::make_shared<const LineIndex>(lexer.content)),
+      ring(std::bit_ceil(std::max<size_t>(window, 2))) {
+}
+
+Lexer::Token Lexer::TokenStream::at(size_t index) const {
+    if (this->buffer != nullptr) {
+        return (*this->buffer)[index];
+    }
+    this->fill(index);
+    if (index >= this->produced) {
+        return this->ring[(this->produced - 1) & (this->ring.size() - 1)]; // TK_EOS
+    }
+    if (!this->retains(index)) {
+        throw std::out_of_range("TokenStream: token " + std::to_string(index) + " is behind the "
+                                + std::to_string(this->ring.size()) + " token window");
+    }
+    return this->ring[index & (this->ring.size() - 1)];
+}
+
+bool Lexer::TokenStream::retains(size_t index) const {
+    return this->buffer != nullptr || index + this->ring.size() >= this->produced;
+}
+
+Lexer::SourceLocation Lexer::TokenStream::location(const Token& token) const {
+    return this->buffer != nullptr ? this->buffer->location(token) : this->lineIndex->locate(token.offset);
+}
+
+void Lexer::TokenStream::fill(size_t index) const {
+    while (!this->ended && this->produced <= index) {
+        Token token = this->lexer->nextToken();
+        this->ended = token.type == TK_EOS;
+        this->ring[this->produced & (this->ring.size() - 1)] = token;
+        this->produced++;
+    }
+}
@@ -0,0 +1,80 @@
+#include "../../include/Tokenizer/Unicode.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+struct Range {
+    char32_t first;
+    char32_t last;
+};
+
+#include "UnicodeTables.inc"
+
+template <size_t N>
+bool contains(const Range (&table)[N], char32_t point) {
+    auto it = std::upper_bound(std::begin(table), std::end(table), point,
+                               [](char32_t value, const Range& range) { return value < range.first; });
+    return it != std::begin(table) && point <= std::prev(it)->last;
+}
+}
+
+bool Lexer::Unicode::isIdStart(char32_t point) {
+    if (point < 0x80) {
+        return (point | 0x20) - 'a' < 26 || point == '$' || point == '_';
+    }
+    return contains(ID_START, point);
+}
+
+bool Lexer::Unicode::isIdPart(char32_t point) {
+    if (point < 0x80) {
+        return isIdStart(point) || point - '0' < 10;
+    }
+    return contains(ID_PART, point);
+}
+
+bool Lexer::Unicode::isSpace(char32_t point) {
+    if (point < 0x80) {
+        return point == ' ' || point == '\t' || point == '\v' || point == '\f';
+    }
+    return contains(SPACE, point);
+}
+
+char32_t Lexer::Unicode::decodeUtf8(std::string_view text, size_t& i) {
+    const unsigned char lead = text[i];
+    if (lead < 0x80) {
+        i++;
+        return lead;
+    }
+    const size_t length = lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc0 ? 2 : 0;
+    if (length == 0 || lead > 0xf4 || i + length > text.size()) {
+        i++;
+        return 0xfffd;
+    }
+    char32_t point = lead & (0x7f >> length);
+    for (size_t k = 1; k < length; k++) {
+        const unsigned char next = text[i + k];
+        if ((next & 0xc0) != 0x80) {
+            i++;
+            return 0xfffd;
+        }
+        point = (point << 6) | (next & 0x3f);
+    }
+    static constexpr char32_t MIN_POINT[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (point < MIN_POINT[length] || point > 0x10ffff || (point >= 0xd800 && point <= 0xdfff)) {
+        i++;
+        return 0xfffd;
+    }
+    i += length;
+    return point;
+}
+
+void Lexer::Unicode::appendUtf16(std::u16string& out, char32_t point) {
+    if (point < 0x10000) {
+        out += static_cast<char16_t>(point);
+        return;
+    }
+    point -= 0x10000;
+    out += static_cast<char16_t>(0xd800 | (point >> 10));
+    out += static_cast<char16_t>(0xdc00 | (point & 0x3ff));
+}
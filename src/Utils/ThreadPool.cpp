@@ -0,0 +1,94 @@
+#include "../../include/Utils/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace {
+/** Pool and deque index of the calling thread when it is a worker. */
+thread_local const Lexer::Utils::ThreadPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+}
+
+Lexer::Utils::ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = defaultThreads();
+    }
+    this->queues.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        this->queues.push_back(std::make_unique<Queue>());
+    }
+    this->workers.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        this->workers.emplace_back([this, i] { this->run(i); });
+    }
+}
+
+Lexer::Utils::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(this->mutex);
+        this->stopping = true;
+    }
+    this->ready.notify_all();
+    for (std::thread& worker : this->workers) {
+        worker.join();
+    }
+}
+
+size_t Lexer::Utils::ThreadPool::defaultThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void Lexer::Utils::ThreadPool::enqueue(std::function<void()> task) {
+    const size_t index = currentPool == this
+        ? currentIndex
+        : this->nextQueue.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+    {
+        std::lock_guard lock(this->queues[index]->mutex);
+        this->queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(this->mutex);
+        this->pending++;
+    }
+    this->ready.notify_one();
+}
+
+bool Lexer::Utils::ThreadPool::take(size_t index, std::function<void()>& task) {
+    {
+        Queue& own = *this->queues[index];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            this->pending--;
+            return true;
+        }
+    }
+    for (size_t i = 1; i < this->queues.size(); i++) {
+        Queue& victim = *this->queues[(index + i) % this->queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            this->pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Lexer::Utils::ThreadPool::run(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        std::function<void()> task;
+        if (this->take(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock lock(this->mutex);
+        this->ready.wait(lock, [this] { return this->stopping || this->pending > 0; });
+        if (this->stopping && this->pending == 0) {
+            return; // stopping, and every queue is drained
+        }
+    }
+}
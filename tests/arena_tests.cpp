@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include "../include/AST/Arena.hpp"
+#include "../include/AST/Parser.hpp"
+#include "../include/Tokenizer/Lexer.hpp"
+#include "test_utils.hpp"
+
+namespace fs = std::filesystem;
+
+TEST(Arena, AlignsAndGrows) {
+    Lexer::AST::Arena arena(64);
+    for (size_t alignment : {1, 2, 8, 16, 64}) {
+        void* address = arena.allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(address) % alignment, 0u);
+    }
+    void* large = arena.allocate(1000, 8);
+    EXPECT_NE(large, nullptr);
+    EXPECT_GE(arena.capacity(), 1000u);
+    EXPECT_GE(arena.used(), 1000u);
+
+    const size_t capacity = arena.capacity();
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_NE(arena.allocate(1000, 8), nullptr);
+    EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(Arena, ReusedAcrossCompilations) {
+    Lexer::AST::Arena arena;
+    size_t capacity = 0;
+    for (const fs::path& path : casePaths()) {
+        Lexer::Lexer lexer = Lexer::Lexer::fromFile(path.string());
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+
+        Lexer::AST::Parser owning(tokens);
+        const std::string expected = printProgram(owning);
+        for (int round = 0; round < 2; round++) {
+            arena.reset();
+            Lexer::AST::Parser parser(tokens, arena);
+            EXPECT_EQ(printProgram(parser), expected) << path;
+            if (!tokens.empty()) {
+                EXPECT_GT(arena.used(), 0u) << path;
+            }
+            // The second parse of the same unit fits in what the first one grew.
+            if (round == 1) {
+                EXPECT_EQ(arena.capacity(), capacity) << path;
+            }
+            capacity = arena.capacity();
+        }
+    }
+}
@@ -4,18 +4,12 @@
 #include "../include/Tokenizer/Lexer.hpp"
 #include "../include/AST/Parser.hpp"
 #include "Optimization/Optimizer.hpp"
+#include "test_utils.hpp"
 
 #include <cstdlib>
 
 namespace fs = std::filesystem;
 
-std::string readFile(const std::string& filePath) {
-    std::ifstream fileStream(filePath);
-    std::stringstream buffer;
-    buffer << fileStream.rdbuf();
-    return buffer.str();
-}
-
 void writeFile(const std::string& filePath, const std::string& content) {
     std::ofstream fileStream(filePath);
     fileStream << content;
@@ -33,10 +27,9 @@ TEST(AutoGeneratedTests /*unused*/, AllCases /*unused*/) {
             out_path.replace_extension(".tmp");
 
             if (fs::exists(cpp_path)) {
-                std::string input = readFile(js_path);
                 std::string expected_output = readFile(cpp_path);
-                Lexer::Lexer lexer(input);
-                std::vector<Lexer::Token> tokens = lexer.tokenize();
+                Lexer::Lexer lexer = Lexer::Lexer::fromFile(js_path);
+                Lexer::TokenBuffer tokens = lexer.tokenize();
 
                 Lexer::AST::Parser parser(tokens);
                 std::vector<Lexer::AST::Stmt::Ptr> ast;
@@ -70,7 +63,7 @@ TEST(AutoGeneratedTests /*unused*/, AllCases /*unused*/) {
                            << "Output mismatch for " << js_path << ". Check " << cpp_path;
 
                 std::cout << std::string(10, '-') << " JAVASCRIPT CODE " << std::string(10, '-') << std::endl;
-                std::cout << input << std::endl;
+                std::cout << lexer.content << std::endl;
                 std::cout << std::string(10, '-') << " GENERATED AST " << std::string(10, '-') << std::endl;
                 for (const auto& stmt : ast) {
                     stmt->print(0);
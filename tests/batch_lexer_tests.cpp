@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "../include/Tokenizer/Lexer.hpp"
+#include "test_utils.hpp"
+
+namespace fs = std::filesystem;
+
+TEST(BatchLexer, FilesMatchSerialLexer) {
+    const std::vector<fs::path> paths = casePaths();
+    std::vector<Lexer::LexedSource> batch = Lexer::lexBatch(paths, 4);
+    ASSERT_EQ(batch.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        Lexer::Lexer serial = Lexer::Lexer::fromFile(paths[i].string());
+        expectSameTokens(serial.tokenize(), batch[i].tokens);
+    }
+    EXPECT_THROW(Lexer::lexBatch(std::vector<fs::path>{"../tests/cases/missing.js"}, 2), std::system_error);
+}
+
+TEST(BatchLexer, SplitsLargeAndPacksSmallSources) {
+    std::vector<std::string> texts;
+    std::string large;
+    for (const fs::path& path : casePaths()) {
+        texts.push_back(readFile(path));
+        large += texts.back() + '\n';
+    }
+    while (large.size() < 1024 * 1024) {
+        large += large;
+    }
+    texts.insert(texts.begin() + texts.size() / 2, large);
+    // Every newline is inside a comment, so each split misreads the string that follows it.
+    std::string strings;
+    while (strings.size() < 1024 * 1024) {
+        strings += "/*\nit's */ 'abc' + x;";
+    }
+    texts.push_back(strings);
+
+    const std::vector<std::string_view> sources(texts.begin(), texts.end());
+    std::vector<Lexer::LexedSource> batch = Lexer::lexBatch(sources, 4);
+    ASSERT_EQ(batch.size(), sources.size());
+    for (size_t i = 0; i < sources.size(); i++) {
+        Lexer::Lexer serial{sources[i]};
+        expectSameTokens(serial.tokenize(), batch[i].tokens);
+    }
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../include/Tokenizer/Lexer.hpp"
+
+TEST(Lexer, DecodesNumbers) {
+    struct Case {
+        const char* source;
+        double value;
+    };
+    for (Case c : {Case{"0", 0}, Case{"42", 42}, Case{"3.25", 3.25}, Case{".5", 0.5}, Case{"5.", 5},
+                   Case{"1e3", 1000}, Case{"2.5E-2", 0.025}, Case{"1e+2", 100}, Case{"0xff", 255}, Case{"0XAbC", 0xabc},
+                   Case{"010", 8}, Case{"0777", 511}, Case{"00", 0}, Case{"0.5", 0.5}}) {
+        Lexer::Lexer lexer(c.source);
+        Lexer::Token token = lexer.nextToken();
+        EXPECT_EQ(token.type, Lexer::TK_NUMBER) << c.source;
+        EXPECT_EQ(token.value, c.source);
+        EXPECT_DOUBLE_EQ(token.number, c.value) << c.source;
+    }
+}
+
+TEST(Lexer, NumbersStopAtOperators) {
+    Lexer::Lexer lexer("10-5+1e2-x.y 1..toString 1.5.toFixed");
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    std::string joined;
+    for (Lexer::Token token : tokens) {
+        joined += std::string(token.value) + " ";
+    }
+    EXPECT_EQ(joined, "10 - 5 + 1e2 - x . y 1. . toString 1.5 . toFixed ");
+    EXPECT_DOUBLE_EQ(tokens[4].number, 100);
+}
+
+TEST(Lexer, RejectsMalformedNumbers) {
+    for (const char* source : {"1.2.3", "3in", "0x", "1e5e", "08a", "08", "09", "078", "019.5"}) {
+        Lexer::Lexer lexer(source);
+        Lexer::Token token = lexer.nextToken();
+        EXPECT_EQ(token.type, Lexer::TK_ILLEGAL) << source;
+        EXPECT_EQ(token.value, source);
+    }
+}
+
+TEST(Lexer, PlainStringsAreNotCopied) {
+    Lexer::Lexer lexer("'plain \"ascii\" text'");
+    Lexer::Token token = lexer.nextToken();
+    EXPECT_EQ(token.type, Lexer::TK_STRING);
+    EXPECT_EQ(token.decoded.data(), nullptr);
+    EXPECT_EQ(token.utf16(), u"plain \"ascii\" text");
+}
+
+TEST(Lexer, DecodesStringEscapes) {
+    struct Case {
+        const char* source;
+        std::u16string value;
+    };
+    for (const Case& c : {Case{R"("a\nb\tc")", u"a\nb\tc"}, Case{R"('it\'s')", u"it's"}, Case{R"("\x41é€")", u"Aé€"},
+                          Case{R"("\0\101\7")", std::u16string(u"\0A\7", 3)}, Case{"\"line\\\ncontinued\\\r\nagain\"", u"linecontinuedagain"},
+                          Case{R"("\q\"\\")", u"q\"\\"}, Case{"\"caf\xc3\xa9 \xf0\x9f\x98\x80\"", u"café \U0001F600"},
+                          Case{"\"bad \xff\"", u"bad �"}}) {
+        Lexer::Lexer lexer(c.source);
+        Lexer::Token token = lexer.nextToken();
+        EXPECT_EQ(token.type, Lexer::TK_STRING) << c.source;
+        EXPECT_NE(token.decoded.data(), nullptr) << c.source;
+        EXPECT_EQ(token.utf16(), c.value) << c.source;
+    }
+}
+
+TEST(Lexer, DecodedStringsSurviveTheBuffer) {
+    Lexer::Lexer lexer("x = '\\u0041'; y = 'plain'; z = 1.5");
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    EXPECT_EQ(tokens[2].utf16(), u"A");
+    EXPECT_EQ(tokens[6].decoded.data(), nullptr);
+    EXPECT_EQ(tokens[6].utf16(), u"plain");
+    EXPECT_DOUBLE_EQ(tokens[10].number, 1.5);
+}
+
+TEST(Lexer, CommentsEndAtEveryLineTerminator) {
+    // A comment spanning lines counts as a line terminator; "\r", LS and PS end a line as well as "\n" does.
+    struct Case {
+        const char* source;
+        bool newlineBefore;
+    };
+    for (Case c : {Case{"a\rb", true}, Case{"a /*\r*/ b", true}, Case{"a /*\n*/ b", true}, Case{"a /* */ b", false},
+                   Case{"a // c\rb", true}, Case{"a // c\r\nb", true}, Case{"a\xE2\x80\xA8" "b", true},
+                   Case{"a /*\xE2\x80\xA8*/ b", true}, Case{"a /*\xE2\x80\xA9*/ b", true},
+                   Case{"a /*\xE2\x80\x83*/ b", false}, Case{"a // c\xE2\x80\xA8" "b", true},
+                   Case{"a // \xE2\x80\x83\xE2\x80\xA9" "b", true}}) {
+        Lexer::Lexer lexer(c.source);
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+        ASSERT_EQ(tokens.size(), 2u) << c.source;
+        EXPECT_EQ(tokens.back().value, "b") << c.source;
+        EXPECT_EQ(tokens.back().newlineBefore, c.newlineBefore) << c.source;
+    }
+}
+
+TEST(Lexer, UnicodeIdentifiersAndSpaces) {
+    // NBSP, ideographic space, BOM and an em space between tokens; LS acts as a line terminator.
+    Lexer::Lexer lexer("var caf\xc3\xa9\xc2\xa0=\xe3\x80\x80\xce\xb1\xce\xb2\xe2\x80\x8c\xef\xbb\xbf+\xe2\x80\x83x\xe2\x80\xa8\xe5\xa4\x89\xe6\x95\xb0_1");
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    ASSERT_EQ(tokens.size(), 7u);
+    EXPECT_EQ(tokens[1].value, "caf\xc3\xa9");
+    EXPECT_EQ(tokens[1].type, Lexer::TK_IDENTIFIER);
+    EXPECT_EQ(tokens[3].value, "\xce\xb1\xce\xb2\xe2\x80\x8c");
+    EXPECT_EQ(tokens[5].value, "x");
+    EXPECT_EQ(tokens[6].value, "\xe5\xa4\x89\xe6\x95\xb0_1");
+    EXPECT_TRUE(tokens[6].newlineBefore);
+    EXPECT_FALSE(tokens[5].newlineBefore);
+}
+
+TEST(Lexer, UnknownCharactersAreIllegalTokens) {
+    Lexer::Lexer lexer("a # \xe2\x86\x92 b");
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    ASSERT_EQ(tokens.size(), 4u);
+    EXPECT_EQ(tokens[1].type, Lexer::TK_ILLEGAL);
+    EXPECT_EQ(tokens[2].type, Lexer::TK_ILLEGAL);
+    EXPECT_EQ(tokens[2].value, "\xe2\x86\x92");
+    EXPECT_EQ(tokens[3].value, "b");
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include "../include/Tokenizer/Lexer.hpp"
+#include "test_utils.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+/** Every test case concatenated until the input is large enough to be split. */
+std::string largeSource() {
+    std::string source;
+    while (source.size() < 2 * 1024 * 1024) {
+        for (const fs::path& path : casePaths()) {
+            source += readFile(path);
+            source += '\n';
+        }
+    }
+    return source;
+}
+}
+
+TEST(ParallelLexer, MatchesSerialLexer) {
+    const std::string source = largeSource();
+    Lexer::Lexer serial{std::string_view(source)};
+    Lexer::Lexer parallel{std::string_view(source)};
+    expectSameTokens(serial.tokenize(), parallel.tokenizeParallel(8));
+}
+
+TEST(ParallelLexer, RecoversFromCutsInsideLiterals) {
+    // Long multi-line comments and strings with line continuations force most cuts to land inside literals.
+    std::string source;
+    while (source.size() < 4 * 1024 * 1024) {
+        source += "/* comment\nvar x = 'not code';\n*/\nvar s = \"a\\\n b\\\n c\";\n";
+        source += std::string(1000, 'a') + " += 1;\n";
+    }
+    source += "/*" + std::string(2 * 1024 * 1024, '\n') + "*/ done;";
+    Lexer::Lexer serial{std::string_view(source)};
+    Lexer::Lexer parallel{std::string_view(source)};
+    expectSameTokens(serial.tokenize(), parallel.tokenizeParallel(8));
+
+    // Every newline is inside a comment, so each cut misreads the string that follows it and the
+    // re-lex has to start at its opening quote.
+    std::string strings;
+    while (strings.size() < 4 * 1024 * 1024) {
+        strings += "/*\nit's */ 'abc' + x;";
+    }
+    Lexer::Lexer serialStrings{std::string_view(strings)};
+    Lexer::Lexer parallelStrings{std::string_view(strings)};
+    expectSameTokens(serialStrings.tokenize(), parallelStrings.tokenizeParallel(8));
+}
@@ -0,0 +1,527 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include "../include/AST/AST.hpp"
+#include "../include/AST/Parser.hpp"
+#include "../include/Tokenizer/Lexer.hpp"
+#include "test_utils.hpp"
+
+namespace {
+/** Printed AST of `source`. */
+std::string printTree(const char* source) {
+    Lexer::Lexer lexer(source);
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    Lexer::AST::Parser parser(tokens);
+    return printProgram(parser);
+}
+
+/** Message of the ParseError thrown while parsing `source`, or "" if it parses. */
+std::string parseError(const char* source) {
+    Lexer::Lexer lexer(source);
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    Lexer::AST::Parser parser(tokens);
+    try {
+        while (!parser.isAtEnd()) {
+            parser.parseStatement();
+        }
+    } catch (const Lexer::AST::ParseError& e) {
+        return e.what();
+    }
+    return "";
+}
+}
+
+TEST(TokenSet, Membership) {
+    constexpr Lexer::TokenSet set = {Lexer::TK_EOS, Lexer::TK_ASSIGN_SHR, Lexer::TK_IDENTIFIER};
+    static_assert(set.contains(Lexer::TK_ASSIGN_SHR));
+    for (int type = 0; type < Lexer::TK_NUM_TOKENS; type++) {
+        const auto token = static_cast<Lexer::TokenType>(type);
+        EXPECT_EQ(set.contains(token), token == Lexer::TK_EOS || token == Lexer::TK_ASSIGN_SHR ||
+                                       token == Lexer::TK_IDENTIFIER) << Lexer::TokenName[type];
+    }
+}
+
+TEST(Parser, ErrorMessages) {
+    EXPECT_EQ(parseError("var a = 1;\nvar = 2;"),
+              "Parser Error: [VarDecl] Expected variable name. at line 1 col 4. Found '='");
+    EXPECT_EQ(parseError("do x++; while (x) y"),
+              "Parser Error: [DoWhileStmt] Expected ';' after do-while statement. at line 0 col 18. Found 'y'.");
+    EXPECT_EQ(parseError("a = {1: 2}"),
+              "Parser Error: [Object] Expected string or identifier as object key. at line 0 col 5. Found '1'");
+    EXPECT_EQ(parseError("a = b ? c : d;\nx += y >>>= 2;"), "");
+}
+
+TEST(Parser, OperatorPrecedence) {
+    EXPECT_EQ(printTree("a || b && c | d ^ e & f == g < h << i + j * k;"), R"(ExpressionStmt
+  BinaryExpr(||)
+    Identifier(a)
+    BinaryExpr(&&)
+      Identifier(b)
+      BinaryExpr(|)
+        Identifier(c)
+        BinaryExpr(^)
+          Identifier(d)
+          BinaryExpr(&)
+            Identifier(e)
+            BinaryExpr(==)
+              Identifier(f)
+              BinaryExpr(<)
+                Identifier(g)
+                BinaryExpr(<<)
+                  Identifier(h)
+                  BinaryExpr(+)
+                    Identifier(i)
+                    BinaryExpr(*)
+                      Identifier(j)
+                      Identifier(k)
+)");
+    EXPECT_EQ(printTree("a * b + c - d * e % f >> g >= h !== i & j | k && l || m;"), R"(ExpressionStmt
+  BinaryExpr(||)
+    BinaryExpr(&&)
+      BinaryExpr(|)
+        BinaryExpr(&)
+          BinaryExpr(!==)
+            BinaryExpr(>=)
+              BinaryExpr(>>)
+                BinaryExpr(-)
+                  BinaryExpr(+)
+                    BinaryExpr(*)
+                      Identifier(a)
+                      Identifier(b)
+                    Identifier(c)
+                  BinaryExpr(%)
+                    BinaryExpr(*)
+                      Identifier(d)
+                      Identifier(e)
+                    Identifier(f)
+                Identifier(g)
+              Identifier(h)
+            Identifier(i)
+          Identifier(j)
+        Identifier(k)
+      Identifier(l)
+    Identifier(m)
+)");
+    EXPECT_EQ(printTree("x = a - b - c, y += a ? b : c = d, z;"), R"(ExpressionStmt
+  BinaryExpr(,)
+    AssignementExpr(=)
+      Identifier(x)
+      BinaryExpr(-)
+        BinaryExpr(-)
+          Identifier(a)
+          Identifier(b)
+        Identifier(c)
+    AssignementExpr(+=)
+      Identifier(y)
+      ConditionalExpr
+        Identifier(a)
+        Identifier(b)
+        BinaryExpr(,)
+          AssignementExpr(=)
+            Identifier(c)
+            Identifier(d)
+          Identifier(z)
+)");
+    EXPECT_EQ(printTree("a in b instanceof c != d === e;"), R"(ExpressionStmt
+  BinaryExpr(===)
+    BinaryExpr(!=)
+      BinaryExpr(instanceof)
+        BinaryExpr(in)
+          Identifier(a)
+          Identifier(b)
+        Identifier(c)
+      Identifier(d)
+    Identifier(e)
+)");
+}
+
+TEST(Parser, ForHeadersAndLabels) {
+    EXPECT_EQ(printTree("for (a.b[c] in o) x;"), R"(ForInStmt
+  ExpressionStmt
+    MemberExpr(non-computed)
+      MemberExpr(computed)
+        Identifier(a)
+        Identifier(b)
+      Identifier(c)
+  Identifier(o)
+Do
+  ExpressionStmt
+    Identifier(x)
+EndForInStmt
+)");
+    // `in` inside parentheses belongs to the init expression, not to a for-in.
+    EXPECT_EQ(printTree("for (x = (a in b); x; ) x;"), R"(ForStmt
+  ExpressionStmt
+    AssignementExpr(=)
+      Identifier(x)
+      GroupedExpr
+        BinaryExpr(in)
+          Identifier(a)
+          Identifier(b)
+  Identifier(x)
+  null
+Do
+  ExpressionStmt
+    Identifier(x)
+EndForStmt
+)");
+    EXPECT_EQ(printTree("outer: a;"), R"(LabeledStmt(outer)
+  ExpressionStmt
+    Identifier(a)
+)");
+    EXPECT_EQ(parseError("for (a + b in o) x;"),
+              "Parser Error: [ForInStmt] Invalid left-hand side in for-in statement at line 0 col 11.");
+}
+
+TEST(Parser, SinglePassOverATwoTokenWindow) {
+    const char* source =
+        "for (var i = 0, total = f(a in b, [c in d]); i < total && !(k in seen); i++) { continue; }\n"
+        "for (var key in object) { loop: while (key) { break loop; } }\n"
+        "for (object.items[index + offset * 2].name in other) label: x = y ? z : w;\n";
+    Lexer::Lexer buffered(source);
+    Lexer::TokenBuffer tokens = buffered.tokenize();
+    Lexer::AST::Parser fromBuffer(tokens);
+    Lexer::Lexer streamed(source);
+    Lexer::AST::Parser fromStream(streamed, 2);
+
+    testing::internal::CaptureStdout();
+    while (!fromBuffer.isAtEnd()) {
+        fromBuffer.parseStatement()->print(0);
+    }
+    const std::string expected = testing::internal::GetCapturedStdout();
+    testing::internal::CaptureStdout();
+    while (!fromStream.isAtEnd()) {
+        fromStream.parseStatement()->print(0);
+    }
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), expected);
+}
+
+TEST(Parser, LazyFunctionBodiesMatchEagerParsing) {
+    for (const std::filesystem::path& path : casePaths()) {
+        Lexer::Lexer lexer = Lexer::Lexer::fromFile(path.string());
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+        Lexer::AST::Parser eager(tokens);
+        Lexer::AST::Parser lazy(tokens, Lexer::AST::PARSE_LAZY_FUNCTIONS);
+        // Printing builds every deferred body.
+        EXPECT_EQ(printProgram(lazy), printProgram(eager)) << path;
+    }
+}
+
+TEST(Parser, LazyFunctionBodiesAreBuiltOnFirstAccess) {
+    Lexer::Lexer lexer("function f(a) { var b = [a, {c: (a)}]; return function () { return b; }; }\n"
+                       "function g() { this is not parsed yet }\n"
+                       "function h() { if (x) { y(); }");
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    Lexer::AST::Arena eagerArena;
+    Lexer::AST::Parser eager(tokens, eagerArena);
+    eager.parseStatement();
+
+    Lexer::AST::Arena arena;
+    Lexer::AST::Parser parser(tokens, arena, Lexer::AST::PARSE_LAZY_FUNCTIONS);
+    Lexer::AST::Stmt::Ptr f = parser.parseStatement();
+    auto* function = dynamic_cast<Lexer::AST::FunctionDecl*>(f.get());
+    ASSERT_NE(function, nullptr);
+    EXPECT_FALSE(function->body.parsed());
+    EXPECT_LT(arena.used(), eagerArena.used());
+    EXPECT_NE(dynamic_cast<const Lexer::AST::BlockStmt*>(function->body.get().get()), nullptr);
+    EXPECT_TRUE(function->body.parsed());
+
+    // Balanced bodies are only checked when built; unbalanced ones fail right away.
+    Lexer::AST::Stmt::Ptr g = parser.parseStatement();
+    EXPECT_THROW(dynamic_cast<Lexer::AST::FunctionDecl*>(g.get())->body.get(), Lexer::AST::ParseError);
+    EXPECT_THROW(parser.parseStatement(), Lexer::AST::ParseError);
+}
+
+namespace {
+/** Printed AST of `tokens` parsed by parseProgram() on `threads` workers, or the error. */
+std::string printParallel(const Lexer::TokenBuffer& tokens, size_t threads) {
+    Lexer::AST::Parser parser(tokens);
+    testing::internal::CaptureStdout();
+    try {
+        for (const Lexer::AST::Stmt::Ptr& statement : parser.parseProgram(threads).statements) {
+            statement->print(0);
+        }
+    } catch (const std::exception& e) {
+        std::cout << "error: " << e.what() << "\n";
+    }
+    return testing::internal::GetCapturedStdout();
+}
+}
+
+TEST(Parser, ParallelBodiesMatchEagerParsing) {
+    for (const std::filesystem::path& path : casePaths()) {
+        Lexer::Lexer lexer = Lexer::Lexer::fromFile(path.string());
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+        Lexer::AST::Parser eager(tokens);
+        std::string expected = printProgram(eager);
+        // parseProgram() returns no statements when it throws.
+        if (size_t error = expected.find("error: "); error != std::string::npos) {
+            expected.erase(0, error);
+        }
+        EXPECT_EQ(printParallel(tokens, 1), expected) << path;
+        EXPECT_EQ(printParallel(tokens, 4), expected) << path;
+    }
+}
+
+TEST(Parser, ParallelBodiesReportTheFirstError) {
+    // Errors in an outer body, a body nested in it, a later body and at the top level: eager parsing stops
+    // at the nested one, and so must every thread count.
+    const char* source = "function a() { function b() { var = 1; } x(;); }\n"
+                         "function c() { var = 2; }\n"
+                         "var f = function () { return 1; };\n"
+                         "var = 3;";
+    Lexer::Lexer lexer(source);
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    const std::string expected = "error: " + parseError(source) + "\n";
+    EXPECT_NE(expected.find("col 34. Found '='"), std::string::npos) << expected;
+    for (size_t threads : {1, 2, 4, 8}) {
+        EXPECT_EQ(printParallel(tokens, threads), expected) << threads;
+    }
+}
+
+namespace {
+/** `depth` times `open`, `inner`, then `depth` times `close`. */
+std::string nest(std::string_view open, std::string_view inner, std::string_view close, size_t depth) {
+    std::string source;
+    for (size_t i = 0; i < depth; i++) {
+        source += open;
+    }
+    source += inner;
+    for (size_t i = 0; i < depth; i++) {
+        source += close;
+    }
+    return source;
+}
+
+/** Message of the ParseError thrown while parsing `source` with `flags` and `limit`, or "" if it parses. */
+std::string parseError(const std::string& source, Lexer::AST::flag_t flags,
+                       size_t limit = Lexer::AST::Parser::NO_DEPTH_LIMIT) {
+    Lexer::Lexer lexer{std::string_view(source)};
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    Lexer::AST::Parser parser(tokens, flags);
+    parser.setDepthLimit(limit);
+    try {
+        while (!parser.isAtEnd()) {
+            parser.parseStatement();
+        }
+    } catch (const Lexer::AST::ParseError& e) {
+        return e.what();
+    }
+    return "";
+}
+}
+
+TEST(Parser, ExplicitStackMatchesRecursiveParsing) {
+    for (const std::filesystem::path& path : casePaths()) {
+        Lexer::Lexer lexer = Lexer::Lexer::fromFile(path.string());
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+        Lexer::AST::Parser recursive(tokens);
+        Lexer::AST::Parser explicitStack(tokens, Lexer::AST::PARSE_EXPLICIT_STACK);
+        EXPECT_EQ(printProgram(explicitStack), printProgram(recursive)) << path;
+    }
+
+    const char* source = "var o = {a: [1, , 2, [,]], 'b': (x, y), c: {}};\n"
+                         "new Foo(1, 2).bar[baz](q, r)(); new Foo; new new Bar()(x).y;\n"
+                         "a = b ? c, d : e = f, g; x += -typeof !y++ * ~z;\n"
+                         "for (k in o.p[0]) { if (a) b(); else if (c) { d; { e; } } else f; }\n"
+                         "lbl: while (x) if (y) break lbl; var g = function (a) { return [a, {k: a}]; };";
+    Lexer::Lexer lexer(source);
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    Lexer::AST::Parser recursive(tokens);
+    Lexer::AST::Parser explicitStack(tokens, Lexer::AST::PARSE_EXPLICIT_STACK);
+    EXPECT_EQ(printProgram(explicitStack), printProgram(recursive));
+
+    for (const char* broken : {"var a = [1, 2;", "x = {a 1};", "f(a, b;", "if (a) { b;", "x = (a ? b);", "new X(1, 2;",
+                               "a.b[c;", "x = {1: 2};", "y = ];"}) {
+        EXPECT_EQ(parseError(broken, Lexer::AST::PARSE_EXPLICIT_STACK), parseError(broken, 0)) << broken;
+        EXPECT_NE(parseError(broken, 0), "") << broken;
+    }
+}
+
+TEST(Parser, ExplicitStackParsesDeepNesting) {
+    // Far deeper than the call stack of the recursive parser allows.
+    constexpr size_t DEPTH = 100000;
+    for (const std::string& source : {nest("[", "1", "]", DEPTH), nest("(", "x", ")", DEPTH),
+                                      "x = " + nest("{a: ", "1", "}", DEPTH) + ";", nest("!", "x", "", DEPTH),
+                                      nest("{", "x;", "}", DEPTH), nest("if (a) x; else ", "y;", "", DEPTH),
+                                      nest("f(", "", ")", DEPTH), nest("a = ", "b", "", DEPTH)}) {
+        EXPECT_EQ(parseError(source, Lexer::AST::PARSE_EXPLICIT_STACK, 2 * DEPTH), "") << source.substr(0, 20);
+    }
+
+    const std::string arrays = nest("[", "1", "]", DEPTH) + ";";
+    Lexer::Lexer lexer{std::string_view(arrays)};
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    Lexer::AST::Parser parser(tokens, Lexer::AST::PARSE_EXPLICIT_STACK);
+    parser.setDepthLimit(2 * DEPTH);
+    Lexer::AST::Stmt::Ptr statement = parser.parseStatement();
+    const Lexer::AST::Expr* expr = dynamic_cast<Lexer::AST::ExpressionStmt&>(*statement).expression.get();
+    size_t depth = 0;
+    while (auto* array = dynamic_cast<const Lexer::AST::Array*>(expr)) {
+        ASSERT_EQ(array->elements.size(), 1u);
+        expr = array->elements[0].get();
+        depth++;
+    }
+    EXPECT_EQ(depth, DEPTH);
+    EXPECT_NE(dynamic_cast<const Lexer::AST::Number*>(expr), nullptr);
+    EXPECT_TRUE(parser.isAtEnd());
+}
+
+TEST(Parser, DepthLimit) {
+    // Both parsers count the same levels and fail at the same token.
+    const std::string deep = nest("[", "1", "]", 100000);
+    const size_t limit = Lexer::AST::Parser::DEFAULT_DEPTH_LIMIT;
+    const std::string error = parseError(deep, 0, limit);
+    EXPECT_EQ(error.rfind("Parser Error: [Parser] Nesting exceeds the depth limit of 1000 at line 0 col 999.", 0), 0u)
+        << error;
+    EXPECT_EQ(parseError(deep, Lexer::AST::PARSE_EXPLICIT_STACK, limit), error);
+
+    // Without a limit, nesting is only bounded by the call stack of the recursive parser.
+    for (Lexer::AST::flag_t flags : {Lexer::AST::flag_t(0), Lexer::AST::flag_t(Lexer::AST::PARSE_EXPLICIT_STACK)}) {
+        EXPECT_EQ(parseError(nest("[", "1", "]", 2000), flags), "") << flags;
+        EXPECT_EQ(parseError(nest("{", "x;", "}", 2000), flags), "") << flags;
+    }
+
+    for (Lexer::AST::flag_t flags : {Lexer::AST::flag_t(0), Lexer::AST::flag_t(Lexer::AST::PARSE_EXPLICIT_STACK)}) {
+        // One level for the statement, one per array and one for the number.
+        EXPECT_EQ(parseError(nest("[", "1", "]", 62), flags, 64), "") << flags;
+        EXPECT_NE(parseError(nest("[", "1", "]", 63), flags, 64), "") << flags;
+        EXPECT_EQ(parseError(nest("{", "x;", "}", 62), flags, 64), "") << flags;
+        EXPECT_NE(parseError(nest("{", "x;", "}", 63), flags, 64), "") << flags;
+
+        // Bodies built by parseProgram() count from their own '{' and keep the limit.
+        const std::string body = "function f() " + nest("{", "x;", "}", 80);
+        EXPECT_NE(parseError(body, flags, 64), "") << flags;
+        Lexer::Lexer lexer{std::string_view(body)};
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+        for (size_t limit : {64, 100}) {
+            Lexer::AST::Parser parser(tokens, flags);
+            parser.setDepthLimit(limit);
+            if (limit < 80) {
+                EXPECT_THROW(parser.parseProgram(1), Lexer::AST::ParseError) << flags;
+            } else {
+                EXPECT_NO_THROW(parser.parseProgram(1)) << flags;
+            }
+        }
+    }
+}
+
+namespace {
+/** Printed AST of `tokens` parsed with PARSE_RECOVER and `flags`, then one line per diagnostic. */
+std::string printRecovered(const Lexer::TokenBuffer& tokens, Lexer::AST::flag_t flags, size_t threads = 0) {
+    Lexer::AST::Parser parser(tokens, Lexer::AST::PARSE_RECOVER | flags);
+    testing::internal::CaptureStdout();
+    if (threads == 0) {
+        while (!parser.isAtEnd()) {
+            parser.parseStatement()->print(0);
+        }
+    } else {
+        for (const Lexer::AST::Stmt::Ptr& statement : parser.parseProgram(threads).statements) {
+            statement->print(0);
+        }
+    }
+    for (const Lexer::AST::Diagnostic& diagnostic : parser.diagnostics()) {
+        std::cout << "error at token " << diagnostic.token << ": " << diagnostic.error.what() << "\n";
+    }
+    return testing::internal::GetCapturedStdout();
+}
+}
+
+TEST(Parser, RecoveryReportsEveryError) {
+    const char* source = "var a = ;\n"
+                         "function f() {\n"
+                         "  var = 1;\n"
+                         "  return a;\n"
+                         "}\n"
+                         "if (a) { b = ); c(); }\n"
+                         "x = [1, 2\n"
+                         "var y = 3;\n"
+                         "}} z;";
+    Lexer::Lexer lexer(source);
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    const std::string recovered = printRecovered(tokens, 0);
+    EXPECT_EQ(recovered,
+              "ErrorStmt\n"
+              "FunctionDecl(f)\n"
+              "  Params:\n"
+              "  Body:\n"
+              "    BlockStmt\n"
+              "      ErrorStmt\n"
+              "      ReturnStmt\n"
+              "        Identifier(a)\n"
+              "    EndBlockStmt\n"
+              "IfStmt\n"
+              "  Identifier(a)\n"
+              "Then\n"
+              "  BlockStmt\n"
+              "    ErrorStmt\n"
+              "    ExpressionStmt\n"
+              "      CallExpr\n"
+              "        Identifier(c)\n"
+              "        Arguments:\n"
+              "  EndBlockStmt\n"
+              "EndIfStmt\n"
+              "ErrorStmt\n"
+              "VarDecl(y)\n"
+              "  Number(3)\n"
+              "ErrorStmt\n"
+              "ErrorStmt\n"
+              "ExpressionStmt\n"
+              "  Identifier(z)\n"
+              "error at token 3: Parser Error: Unexpected token in primary expression: ; of type TK_SEMICOLON at line 0 col 8.\n"
+              "error at token 10: Parser Error: [VarDecl] Expected variable name. at line 2 col 6. Found '='\n"
+              "error at token 24: Parser Error: Unexpected token in primary expression: ) of type TK_RPAREN at line 5 col 13.\n"
+              "error at token 37: Parser Error: [Array] Expected ']' at end of array literal. at line 7 col 0. Found 'var'\n"
+              "error at token 42: Parser Error: Unexpected token in primary expression: } of type TK_RBRACE at line 8 col 0.\n"
+              "error at token 43: Parser Error: Unexpected token in primary expression: } of type TK_RBRACE at line 8 col 1.\n");
+    // The first diagnostic is the error a plain parse stops at.
+    const std::string first = parseError(source);
+    EXPECT_NE(recovered.find(": " + first + "\n"), std::string::npos) << first;
+
+    EXPECT_EQ(printRecovered(tokens, Lexer::AST::PARSE_EXPLICIT_STACK), recovered);
+    for (size_t threads : {1, 4}) {
+        EXPECT_EQ(printRecovered(tokens, 0, threads), recovered) << threads;
+    }
+
+    // A ';' or '}' inside brackets the statement opened before the error does not end it.
+    const std::pair<const char*, const char*> unclosed[] = {
+        {"x = {a: 1, b: };\ny();",
+         "ErrorStmt\n"
+         "ExpressionStmt\n"
+         "  CallExpr\n"
+         "    Identifier(y)\n"
+         "    Arguments:\n"
+         "error at token 9: Parser Error: Unexpected token in primary expression: } of type TK_RBRACE at line 0 col 14.\n"},
+        {"for (var i = 0; i < ; i++) { a(); }\nz();",
+         "ErrorStmt\n"
+         "ExpressionStmt\n"
+         "  CallExpr\n"
+         "    Identifier(z)\n"
+         "    Arguments:\n"
+         "error at token 9: Parser Error: Unexpected token in primary expression: ; of type TK_SEMICOLON at line 0 col 20.\n"},
+    };
+    for (const auto& [broken, expected] : unclosed) {
+        Lexer::Lexer brokenLexer(broken);
+        Lexer::TokenBuffer brokenTokens = brokenLexer.tokenize();
+        EXPECT_EQ(printRecovered(brokenTokens, 0), expected) << broken;
+        EXPECT_EQ(printRecovered(brokenTokens, Lexer::AST::PARSE_EXPLICIT_STACK), expected) << broken;
+    }
+}
+
+TEST(Parser, RecoveryKeepsValidSourcesUnchanged) {
+    for (const std::filesystem::path& path : casePaths()) {
+        Lexer::Lexer lexer = Lexer::Lexer::fromFile(path.string());
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+        Lexer::AST::Parser plain(tokens);
+        const std::string expected = printProgram(plain);
+        const std::string recovered = printRecovered(tokens, 0);
+        if (expected.find("error: ") == std::string::npos) {
+            EXPECT_EQ(recovered, expected) << path;
+        } else {
+            // Everything up to the first error is the same, and so is the error.
+            const size_t error = expected.find("error: ");
+            EXPECT_EQ(recovered.substr(0, error), expected.substr(0, error)) << path;
+            const std::string message = expected.substr(error + 7);
+            EXPECT_NE(recovered.find(": " + message), std::string::npos) << path;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <random>
+#include <string>
+#include "../include/Tokenizer/Lexer.hpp"
+#include "test_utils.hpp"
+
+namespace fs = std::filesystem;
+
+TEST(Relex, SmallEdits) {
+    std::string before = "var a = 1;\nvar name = 'x';\n// comment\nfoo(a, name);\n";
+    Lexer::Lexer lexer{std::string_view(before)};
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+
+    std::string after = "var a = 12;\nvar name = 'x';\n// comment\nfoo(a, name);\n";
+    lexer.relex(tokens, after, {9, 0, "2"});
+    Lexer::Lexer full{std::string_view(after)};
+    expectSameTokens(full.tokenize(), tokens, "insert digit");
+    EXPECT_EQ(tokens[3].number, 12);
+    EXPECT_EQ(tokens[10].value, "foo");
+
+    EXPECT_THROW(lexer.relex(tokens, after, {0, 1, "x"}), std::invalid_argument);
+}
+
+TEST(Relex, EditsInsideACodePointAfterAToken) {
+    // An identifier decodes the whole code point after it to see whether it goes on: U+2003 (an em space)
+    // ends it, and changing its last byte to make U+200C (ZWNJ) extends it.
+    std::string before = "a\xE2\x80\x83;";
+    Lexer::Lexer lexer{std::string_view(before)};
+    Lexer::TokenBuffer tokens = lexer.tokenize();
+    ASSERT_EQ(tokens.size(), 2u);
+
+    std::string after = "a\xE2\x80\x8C;";
+    lexer.relex(tokens, after, {3, 1, "\x8C"});
+    Lexer::Lexer full{std::string_view(after)};
+    expectSameTokens(full.tokenize(), tokens, "continuation byte");
+    EXPECT_EQ(tokens[0].value, "a\xE2\x80\x8C");
+}
+
+TEST(Relex, RandomEditsMatchFullLexing) {
+    // Edits that open or close strings and comments force long re-lexes; the rest resync quickly.
+    const std::string snippets[] = {"'", "\"", "/*", "*/", "//", "\n", " ", "x", "1", ".", "5.", "e", "\\", "é", "+=", ";"};
+    std::mt19937 rng(7);
+    for (const fs::path& path : casePaths()) {
+        std::string text = readFile(path);
+        std::string previous = text;
+
+        Lexer::Lexer lexer{std::string_view(previous)};
+        Lexer::TokenBuffer tokens = lexer.tokenize();
+        for (int round = 0; round < 20; round++) {
+            size_t offset = std::uniform_int_distribution<size_t>(0, text.size())(rng);
+            size_t removed = std::min<size_t>(std::uniform_int_distribution<size_t>(0, 3)(rng), text.size() - offset);
+            std::string inserted = round % 3 == 0 ? "" : snippets[rng() % std::size(snippets)];
+            text.replace(offset, removed, inserted);
+
+            lexer.relex(tokens, text, {offset, removed, inserted});
+            Lexer::Lexer full{std::string_view(text)};
+            expectSameTokens(full.tokenize(), tokens, path.string() + " round " + std::to_string(round));
+            // `tokens` now views `text`; keep a copy for the next edit to replace.
+            previous = text;
+            lexer.relex(tokens, previous, {0, 0, ""});
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include "../include/Tokenizer/Scanner.hpp"
+
+namespace Scan = Lexer::Scan;
+
+namespace {
+// Bytes the kernels care about, plus identifier/non-ASCII filler so runs cross block boundaries.
+std::string randomSource(std::mt19937& rng, size_t size) {
+    static const std::string alphabet = "aZ09_$ \t\v\f\n*/\"';{}.+\x80\xff";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<int> run(0, 3);
+    std::string out;
+    while (out.size() < size) {
+        char ch = alphabet[pick(rng)];
+        out.append(run(rng) == 0 ? 40 : 1, ch);
+    }
+    out.resize(size);
+    return out;
+}
+}
+
+TEST(Scanner, KernelsMatchScalar) {
+    std::mt19937 rng(1234);
+    const Scan::Isa best = Scan::bestIsa();
+    for (Scan::Isa isa : {Scan::Isa::SSE2, Scan::Isa::AVX2}) {
+        if (!Scan::useIsa(isa)) {
+            continue;
+        }
+        for (size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 100, 517}) {
+            std::string text = randomSource(rng, size);
+            for (size_t from = 0; from <= size; from++) {
+                Scan::useIsa(Scan::Isa::SCALAR);
+                size_t newline = Scan::findNewline(text, from);
+                size_t commentEnd = Scan::findCommentEnd(text, from);
+                size_t quote = Scan::findQuoteOrBackslash(text, from, '"');
+                size_t identifier = Scan::findNonIdentifier(text, from);
+                size_t space = Scan::findNonSpace(text, from);
+                Scan::useIsa(isa);
+                ASSERT_EQ(Scan::findNewline(text, from), newline) << Scan::isaName(isa) << " from " << from;
+                ASSERT_EQ(Scan::findCommentEnd(text, from), commentEnd) << Scan::isaName(isa) << " from " << from;
+                ASSERT_EQ(Scan::findQuoteOrBackslash(text, from, '"'), quote) << Scan::isaName(isa) << " from " << from;
+                ASSERT_EQ(Scan::findNonIdentifier(text, from), identifier) << Scan::isaName(isa) << " from " << from;
+                ASSERT_EQ(Scan::findNonSpace(text, from), space) << Scan::isaName(isa) << " from " << from;
+            }
+        }
+    }
+    Scan::useIsa(best);
+}
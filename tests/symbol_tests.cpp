@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/Tokenizer/Symbol.hpp"
+
+TEST(Symbol, EqualNamesShareOneId) {
+    std::string owned = "counter";
+    Lexer::Symbol a = Lexer::Symbol::intern(owned);
+    owned = "changed";
+    Lexer::Symbol b = Lexer::Symbol::intern("counter");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.str(), "counter");
+    EXPECT_NE(a, Lexer::Symbol::intern("Counter"));
+    EXPECT_TRUE(Lexer::Symbol::intern("").empty());
+    EXPECT_EQ(Lexer::Symbol::intern(""), Lexer::Symbol());
+}
+
+TEST(Symbol, ConcurrentInterning) {
+    std::vector<std::vector<Lexer::Symbol>> results(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); t++) {
+        threads.emplace_back([&results, t] {
+            for (int i = 0; i < 2000; i++) {
+                results[t].push_back(Lexer::Symbol::intern("name" + std::to_string(i)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (size_t t = 1; t < results.size(); t++) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    EXPECT_EQ(results[0][42].str(), "name42");
+}
@@ -0,0 +1,58 @@
+#ifndef TEST_UTILS_HPP
+#define TEST_UTILS_HPP
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/AST/Parser.hpp"
+#include "../include/Tokenizer/Lexer.hpp"
+
+/** Every `.js` test case, run from the build directory. */
+inline std::vector<std::filesystem::path> casePaths() {
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator("../tests/cases/basic")) {
+        if (entry.path().extension() == ".js") {
+            paths.push_back(entry.path());
+        }
+    }
+    return paths;
+}
+
+inline std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+inline void expectSameTokens(const Lexer::TokenBuffer& expected, const Lexer::TokenBuffer& actual,
+                             const std::string& context = "") {
+    ASSERT_EQ(actual.size(), expected.size()) << context;
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(actual.type(i), expected.type(i)) << context << " token " << i;
+        ASSERT_EQ(actual.start(i), expected.start(i)) << context << " token " << i;
+        ASSERT_EQ(actual.length(i), expected.length(i)) << context << " token " << i;
+        ASSERT_EQ(actual.newlineBefore(i), expected.newlineBefore(i)) << context << " token " << i;
+        ASSERT_EQ(actual[i].number, expected[i].number) << context << " token " << i;
+        ASSERT_EQ(actual[i].utf16(), expected[i].utf16()) << context << " token " << i;
+    }
+}
+
+/** Printed AST of the statements left in `parser`, or of the statements before an error and the error. */
+inline std::string printProgram(Lexer::AST::Parser& parser) {
+    testing::internal::CaptureStdout();
+    try {
+        while (!parser.isAtEnd()) {
+            parser.parseStatement()->print(0);
+        }
+    } catch (const std::exception& e) {
+        std::cout << "error: " << e.what() << "\n";
+    }
+    return testing::internal::GetCapturedStdout();
+}
+
+#endif //TEST_UTILS_HPP
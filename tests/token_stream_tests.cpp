@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "../include/AST/Parser.hpp"
+#include "../include/Tokenizer/Lexer.hpp"
+#include "../include/Tokenizer/TokenStream.hpp"
+#include "test_utils.hpp"
+
+namespace fs = std::filesystem;
+
+TEST(TokenStream, MatchesTokenBuffer) {
+    Lexer::Lexer buffered("var a = 1;\nfor (var k in o) { if (k) break\n}\nreturn");
+    Lexer::TokenBuffer tokens = buffered.tokenize();
+    Lexer::Lexer streamed(buffered.content);
+    Lexer::TokenStream stream(streamed, 4);
+    for (size_t i = 0; i <= tokens.size(); i++) {
+        Lexer::Token expected = tokens[i];
+        Lexer::Token actual = stream.at(i);
+        ASSERT_EQ(actual.type, expected.type) << "token " << i;
+        ASSERT_EQ(actual.value, expected.value) << "token " << i;
+        ASSERT_EQ(actual.offset, expected.offset) << "token " << i;
+        ASSERT_EQ(actual.newlineBefore, expected.newlineBefore) << "token " << i;
+    }
+    EXPECT_EQ(stream.at(tokens.size() + 10).type, Lexer::TK_EOS);
+}
+
+TEST(TokenStream, WindowIsBounded) {
+    Lexer::Lexer lexer("a b c d e f g h i j");
+    Lexer::TokenStream stream(lexer, 4);
+    EXPECT_EQ(stream.at(8).value, "i");
+    EXPECT_TRUE(stream.retains(5));
+    EXPECT_FALSE(stream.retains(4));
+    EXPECT_THROW(stream.at(0), std::out_of_range);
+}
+
+TEST(TokenStream, StreamingParserMatchesBufferedParser) {
+    for (const fs::path& path : casePaths()) {
+        Lexer::Lexer buffered = Lexer::Lexer::fromFile(path.string());
+        Lexer::TokenBuffer tokens = buffered.tokenize();
+        Lexer::AST::Parser fromBuffer(tokens);
+
+        Lexer::Lexer streamed = Lexer::Lexer::fromFile(path.string());
+        Lexer::AST::Parser fromStream(streamed, 64);
+
+        EXPECT_EQ(printProgram(fromStream), printProgram(fromBuffer)) << path;
+    }
+}